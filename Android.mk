@@ -52,6 +52,10 @@ ifeq ($(TARGET_BOARD_PLATFORM), volcano)
 LOCAL_CFLAGS        += -DWSA_V883X_ADDR
 endif
 
+ifeq ($(TARGET_BUILD_VARIANT), eng)
+LOCAL_CFLAGS        += -DPAL_LOCK_ORDER_CHECK
+endif
+
 LOCAL_C_INCLUDES := \
     $(TOP)/system/media/audio_route/include \
     $(TOP)/system/media/audio/include
@@ -93,6 +97,8 @@ LOCAL_SRC_FILES := \
     stream/src/StreamUltraSound.cpp \
     stream/src/StreamSensorPCMData.cpp\
     stream/src/StreamHaptics.cpp \
+    stream/src/WarmStreamPool.cpp \
+    stream/src/VolumeScheduler.cpp \
     device/src/Headphone.cpp \
     device/src/USBAudio.cpp \
     device/src/Device.cpp \
@@ -120,6 +126,7 @@ LOCAL_SRC_FILES := \
     session/src/SessionAlsaPcm.cpp \
     session/src/SessionAgm.cpp \
     session/src/SessionAlsaUtils.cpp \
+    session/src/TimestampCache.cpp \
     session/src/SessionAlsaCompress.cpp \
     session/src/SessionAlsaVoice.cpp \
     session/src/SoundTriggerEngine.cpp \
@@ -137,7 +144,13 @@ LOCAL_SRC_FILES := \
     utils/src/SignalHandler.cpp \
     utils/src/AudioHapticsInterface.cpp \
     utils/src/MetadataParser.cpp \
-    utils/src/MemLogBuilder.cpp
+    utils/src/MemLogBuilder.cpp \
+    utils/src/CalibrationScheduler.cpp \
+    utils/src/OffloadWorkerPool.cpp \
+    utils/src/PalMutex.cpp \
+    utils/src/PowerVote.cpp \
+    utils/src/TimerScheduler.cpp \
+    utils/src/ThreadPolicy.cpp
 
 LOCAL_HEADER_LIBRARIES := \
     libarpal_headers \
@@ -71,6 +71,9 @@
 #include <mutex>
 #include <PalApi.h>
 #include "Stream.h"
+#include "WarmStreamPool.h"
+#include "OffloadWorkerPool.h"
+#include "VolumeScheduler.h"
 #include "Device.h"
 #include "ResourceManager.h"
 #include "PalCommon.h"
@@ -107,6 +110,19 @@ static void notify_concurrent_stream(pal_stream_type_t type,
     rm->ConcurrentStreamStatus(type, dir, active);
 }
 
+/*
+ * set while an executor worker runs a pal_stream_*_async operation and its
+ * ASYNC_DONE callback, so sync calls made from there don't wait on themselves
+ */
+static thread_local bool in_async_op = false;
+
+/* keep sync calls, reads and writes ordered after queued async operations */
+static void wait_async_ops(Stream *s)
+{
+    if (s->asyncPending.load() && !in_async_op)
+        OffloadWorkerPool::getInstance()->waitIdle(&s->asyncTask);
+}
+
 /*
  * pal_init - Initialize PAL
  *
@@ -185,6 +201,7 @@ void pal_deinit(void)
         goto exit;
     }
     kpiEnqueue(__func__, true);
+    WarmStreamPool::deinit();
     rm->deInitContextManager();
     kpiEnqueue(__func__, false);
 
@@ -232,9 +249,19 @@ int32_t pal_stream_open(struct pal_stream_attributes *attributes,
     }
 #endif
 
+    s = WarmStreamPool::acquire(attributes, no_of_devices, devices, no_of_modifiers);
+    if (s) {
+        PAL_DBG(LOG_TAG, "using warm stream %pK", s);
+        goto stream_ready;
+    }
+
     try {
         s = Stream::create(attributes, devices, no_of_devices, modifiers,
                            no_of_modifiers);
+        /* parked warm streams count against session limits, release them */
+        if (!s && WarmStreamPool::flush())
+            s = Stream::create(attributes, devices, no_of_devices, modifiers,
+                               no_of_modifiers);
     } catch (const std::exception& e) {
         status = -EINVAL;
         PAL_ERR(LOG_TAG, "Stream create failed: %s", e.what());
@@ -256,11 +283,14 @@ int32_t pal_stream_open(struct pal_stream_attributes *attributes,
         goto exit;
     }
 
+stream_ready:
     s->getStreamAttributes(&sAttr);
     notify_concurrent_stream(sAttr.type, sAttr.direction, true);
 
     if (cb)
        s->registerCallBack(cb, cookie);
+    s->asyncCb = cb;
+    s->asyncCookie = cookie;
 
     rm->initStreamUserCounter(s);
     stream = reinterpret_cast<uint64_t *>(s);
@@ -271,11 +301,61 @@ exit:
     return status;
 }
 
+/*
+ * Closes a validated stream. *freeStream is set when the caller owns the
+ * stream and must delete it, i.e. it was neither parked in the warm pool
+ * nor is being closed by another client.
+ */
+static int32_t close_stream(Stream *s, bool allowPark, bool *freeStream)
+{
+    int status = 0;
+    bool warm = false;
+    struct pal_stream_attributes sAttr = {};
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+
+    *freeStream = false;
+    VolumeScheduler::getInstance()->cancel(s);
+    s->setCachedState(STREAM_IDLE);
+    warm = allowPark && WarmStreamPool::canPark(s);
+    if (warm)
+        status = WarmStreamPool::quiesce(s);
+    else
+        status = s->close();
+
+    if (rm->deactivateStreamUserCounter(s)) {
+        PAL_ERR(LOG_TAG, "stream is being closed by another client");
+        return 0;
+    }
+
+    if (0 != status) {
+        PAL_ERR(LOG_TAG, "stream closed failed. status %d", status);
+        goto exit;
+    }
+exit:
+    s->getStreamAttributes(&sAttr);
+    notify_concurrent_stream(sAttr.type, sAttr.direction, false);
+    if (sAttr.type == PAL_STREAM_VOICE_CALL)
+        rm->isCRSCallEnabled = false;
+    rm->eraseStreamUserCounter(s);
+    if (warm && !status) {
+        /* a parked stream can be handed to a new client, drop its executor */
+        OffloadWorkerPool::getInstance()->detach(&s->asyncTask);
+        if (WarmStreamPool::park(s)) {
+            PAL_INFO(LOG_TAG, "stream parked in warm pool");
+            return status;
+        }
+    }
+    if (warm && s->close() != 0)
+        PAL_ERR(LOG_TAG, "stream closed failed.");
+    *freeStream = true;
+    return status;
+}
+
 int32_t pal_stream_close(pal_stream_handle_t *stream_handle)
 {
     Stream *s = NULL;
     int status = 0;
-    struct pal_stream_attributes sAttr = {};
+    bool freeStream = false;
     std::shared_ptr<ResourceManager> rm = NULL;
     if (!stream_handle) {
         status = -EINVAL;
@@ -302,25 +382,12 @@ int32_t pal_stream_close(pal_stream_handle_t *stream_handle)
     rm->unlockActiveStream();
 
     s = reinterpret_cast<Stream *>(stream_handle);
-    s->setCachedState(STREAM_IDLE);
-    status = s->close();
-
-    if (rm->deactivateStreamUserCounter(s)) {
-        PAL_ERR(LOG_TAG, "stream is being closed by another client");
-        return 0;
-    }
-
-    if (0 != status) {
-        PAL_ERR(LOG_TAG, "stream closed failed. status %d", status);
-        goto exit;
+    wait_async_ops(s);
+    status = close_stream(s, true, &freeStream);
+    if (freeStream) {
+        OffloadWorkerPool::getInstance()->detach(&s->asyncTask);
+        delete s;
     }
-exit:
-    s->getStreamAttributes(&sAttr);
-    notify_concurrent_stream(sAttr.type, sAttr.direction, false);
-    if (sAttr.type == PAL_STREAM_VOICE_CALL)
-        rm->isCRSCallEnabled = false;
-    rm->eraseStreamUserCounter(s);
-    delete s;
     PAL_INFO(LOG_TAG, "Exit. status %d", status);
     kpiEnqueue(__func__, false);
     return status;
@@ -369,6 +436,7 @@ int32_t pal_stream_start(pal_stream_handle_t *stream_handle)
     }
     rm->unlockActiveStream();
 
+    wait_async_ops(s);
     s->getStreamAttributes(&sAttr);
     if (sAttr.type == PAL_STREAM_VOICE_UI)
         rm->handleDeferredSwitch();
@@ -426,6 +494,7 @@ int32_t pal_stream_stop(pal_stream_handle_t *stream_handle)
         goto exit;
     }
     rm->unlockActiveStream();
+    wait_async_ops(s);
     s->setCachedState(STREAM_STOPPED);
     status = s->stop();
 
@@ -455,6 +524,7 @@ ssize_t pal_stream_write(pal_stream_handle_t *stream_handle, struct pal_buffer *
     }
     PAL_VERBOSE(LOG_TAG, "Enter. Stream handle :%pK", stream_handle);
     s =  reinterpret_cast<Stream *>(stream_handle);
+    wait_async_ops(s);
     status = s->write(buf);
     if (status < 0) {
         PAL_ERR(LOG_TAG, "stream write failed status %d", status);
@@ -475,6 +545,7 @@ ssize_t pal_stream_read(pal_stream_handle_t *stream_handle, struct pal_buffer *b
     }
     PAL_VERBOSE(LOG_TAG, "Enter. Stream handle :%pK", stream_handle);
     s =  reinterpret_cast<Stream *>(stream_handle);
+    wait_async_ops(s);
     status = s->read(buf);
     if (status < 0) {
         PAL_ERR(LOG_TAG, "stream read failed status %d", status);
@@ -555,11 +626,74 @@ int32_t pal_stream_set_param(pal_stream_handle_t *stream_handle, uint32_t param_
     return status;
 }
 
+int32_t pal_stream_set_params(pal_stream_handle_t *stream_handle,
+                              uint32_t no_of_params, uint32_t *param_ids,
+                              pal_param_payload **param_payloads)
+{
+    Stream *s = NULL;
+    int status;
+    uint32_t i = 0;
+    std::shared_ptr<ResourceManager> rm = NULL;
+
+    if (!stream_handle || !no_of_params || !param_ids || !param_payloads) {
+        status = -EINVAL;
+        PAL_ERR(LOG_TAG, "Invalid input parameters status %d", status);
+        return status;
+    }
+    rm = ResourceManager::getInstance();
+    if (!rm) {
+        status = -EINVAL;
+        PAL_ERR(LOG_TAG, "Invalid resource manager");
+        return status;
+    }
+    PAL_DBG(LOG_TAG, "Enter. Stream handle :%pK no_of_params %u", stream_handle,
+            no_of_params);
+    kpiEnqueue(__func__, true);
+
+    rm->lockActiveStream();
+    if (!rm->isActiveStream(stream_handle)) {
+        rm->unlockActiveStream();
+        status = -EINVAL;
+        goto exit;
+    }
+    s =  reinterpret_cast<Stream *>(stream_handle);
+    status = rm->increaseStreamUserCounter(s);
+    if (0 != status) {
+        rm->unlockActiveStream();
+        PAL_ERR(LOG_TAG, "failed to increase stream user count");
+        goto exit;
+    }
+    rm->unlockActiveStream();
+
+    status = s->setParameterBatch(no_of_params, param_ids, param_payloads);
+
+    rm->lockActiveStream();
+    rm->decreaseStreamUserCounter(s);
+    rm->unlockActiveStream();
+
+    if (0 != status) {
+        PAL_ERR(LOG_TAG, "set parameters failed status %d", status);
+        goto exit;
+    }
+    for (i = 0; i < no_of_params; i++) {
+        if (param_ids[i] == PAL_PARAM_ID_STOP_BUFFERING) {
+            PAL_DBG(LOG_TAG, "Buffering stopped, handle deferred LPI<->NLPI switch");
+            rm->handleDeferredSwitch();
+            break;
+        }
+    }
+exit:
+    PAL_DBG(LOG_TAG, "Exit. status %d", status);
+    kpiEnqueue(__func__, false);
+    return status;
+}
+
 int32_t pal_stream_set_volume(pal_stream_handle_t *stream_handle,
                               struct pal_volume_data *volume)
 {
     Stream *s = NULL;
     int status;
+    uint64_t seq = 0;
     std::shared_ptr<ResourceManager> rm = NULL;
     rm = ResourceManager::getInstance();
     if (!rm) {
@@ -568,7 +702,8 @@ int32_t pal_stream_set_volume(pal_stream_handle_t *stream_handle,
         return status;
     }
 
-    if (!stream_handle || !volume || volume->no_of_volpair > PAL_MAX_CHANNELS_SUPPORTED) {
+    if (!stream_handle || !volume || volume->no_of_volpair == 0 ||
+        volume->no_of_volpair > PAL_MAX_CHANNELS_SUPPORTED) {
         status = -EINVAL;
         PAL_ERR(LOG_TAG,"Invalid input parameters status %d", status);
         return status;
@@ -592,9 +727,9 @@ int32_t pal_stream_set_volume(pal_stream_handle_t *stream_handle,
     }
     rm->unlockActiveStream();
 
-    s->lockStreamMutex();
-    status = s->setVolume(volume);
-    s->unlockStreamMutex();
+    seq = s->nextVolumeSeq();
+    if (!VolumeScheduler::getInstance()->defer(s, volume, seq))
+        status = s->setVolumeOrdered(volume, seq);
 
     rm->lockActiveStream();
     rm->decreaseStreamUserCounter(s);
@@ -647,7 +782,8 @@ int32_t pal_stream_set_mute(pal_stream_handle_t *stream_handle, bool state)
         goto exit;
     }
     rm->unlockActiveStream();
-    status = s->mute(state);
+    if (!s->postControl(STREAM_CTRL_MUTE, &state, sizeof(state)))
+        status = s->mute(state);
 
     rm->lockActiveStream();
     rm->decreaseStreamUserCounter(s);
@@ -686,6 +822,7 @@ int32_t pal_stream_pause(pal_stream_handle_t *stream_handle)
     PAL_DBG(LOG_TAG, "Enter. Stream handle :%pK", stream_handle);
     kpiEnqueue(__func__, true);
     s =  reinterpret_cast<Stream *>(stream_handle);
+    wait_async_ops(s);
     status = s->pause();
     if (0 != status) {
         PAL_ERR(LOG_TAG, "pal_stream_pause failed with status %d", status);
@@ -719,6 +856,7 @@ int32_t pal_stream_resume(pal_stream_handle_t *stream_handle)
     PAL_DBG(LOG_TAG, "Enter. Stream handle :%pK", stream_handle);
     kpiEnqueue(__func__, true);
     s =  reinterpret_cast<Stream *>(stream_handle);
+    wait_async_ops(s);
 
     status = s->resume();
     if (0 != status) {
@@ -770,6 +908,7 @@ int32_t pal_stream_drain(pal_stream_handle_t *stream_handle, pal_drain_type_t ty
     }
     rm->unlockActiveStream();
 
+    wait_async_ops(s);
     status = s->drain(type);
 
     rm->lockActiveStream();
@@ -808,6 +947,7 @@ int32_t pal_stream_flush(pal_stream_handle_t *stream_handle)
     PAL_DBG(LOG_TAG, "Enter. Stream handle :%pK", stream_handle);
     kpiEnqueue(__func__, true);
     s =  reinterpret_cast<Stream *>(stream_handle);
+    wait_async_ops(s);
 
     status = s->flush();
     if (0 != status) {
@@ -1023,6 +1163,7 @@ int32_t pal_stream_set_device(pal_stream_handle_t *stream_handle,
     }
     rm->unlockActiveStream();
 
+    wait_async_ops(s);
     s->getStreamAttributes(&sattr);
 
     // device switch will be handled in global param setting for SVA
@@ -1165,6 +1306,173 @@ exit:
     return status;
 }
 
+/* executor handler, runs the queued operations of one stream in post order */
+static void pal_async_op_handler(void *cookie, int op)
+{
+    Stream *s = reinterpret_cast<Stream *>(cookie);
+    pal_stream_handle_t *stream_handle = reinterpret_cast<pal_stream_handle_t *>(s);
+    struct pal_event_async_done_payload done = {};
+    std::vector<struct pal_device> devices;
+    bool freeStream = false;
+
+    in_async_op = true;
+    done.op = op;
+    switch (op) {
+    case PAL_ASYNC_OP_START:
+        done.status = pal_stream_start(stream_handle);
+        break;
+    case PAL_ASYNC_OP_STOP:
+        done.status = pal_stream_stop(stream_handle);
+        break;
+    case PAL_ASYNC_OP_SET_DEVICE:
+        s->asyncMutex.lock();
+        devices.swap(s->asyncDevices.front());
+        s->asyncDevices.pop_front();
+        s->asyncMutex.unlock();
+        done.status = pal_stream_set_device(stream_handle, devices.size(),
+                                            devices.data());
+        break;
+    case PAL_ASYNC_OP_CLOSE:
+        PAL_INFO(LOG_TAG, "async close, stream handle %pK", stream_handle);
+        /* close waits for the stream users to drain, ours included */
+        release_async_op_user(s);
+        done.status = close_stream(s, false, &freeStream);
+        s->asyncCloseFree = freeStream;
+        break;
+    default:
+        PAL_ERR(LOG_TAG, "unknown async op %d", op);
+        done.status = -EINVAL;
+        break;
+    }
+    if (op != PAL_ASYNC_OP_CLOSE)
+        release_async_op_user(s);
+
+    PAL_DBG(LOG_TAG, "async op %d done, status %d", op, done.status);
+    if (s->asyncCb)
+        s->asyncCb(stream_handle, PAL_STREAM_CBK_EVENT_ASYNC_DONE,
+                   (uint32_t *)&done, sizeof(done), s->asyncCookie);
+
+    /* keep pal_stream_close on other threads waiting until the callback returns */
+    s->asyncPending--;
+    in_async_op = false;
+}
+
+/* drop the user count post_async_op took for a queued operation */
+static void release_async_op_user(Stream *s)
+{
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+
+    rm->lockActiveStream();
+    rm->decreaseStreamUserCounter(s);
+    rm->unlockActiveStream();
+}
+
+/* called once the final (close) operation has run and the task is detached */
+static void pal_async_release(void *cookie, int /*op*/)
+{
+    Stream *s = reinterpret_cast<Stream *>(cookie);
+
+    if (s->asyncCloseFree)
+        delete s;
+}
+
+static int32_t post_async_op(pal_stream_handle_t *stream_handle, pal_async_op_t op,
+                             uint32_t no_of_devices, struct pal_device *devices)
+{
+    Stream *s = NULL;
+    OffloadWorkerPool *pool = OffloadWorkerPool::getInstance();
+    std::shared_ptr<ResourceManager> rm = NULL;
+    int status = 0;
+
+    if (!stream_handle) {
+        status = -EINVAL;
+        PAL_ERR(LOG_TAG, "Invalid stream handle status %d", status);
+        return status;
+    }
+
+    rm = ResourceManager::getInstance();
+    if (!rm) {
+        PAL_ERR(LOG_TAG, "Invalid resource manager");
+        return -EINVAL;
+    }
+
+    rm->lockActiveStream();
+    if (!rm->isActiveStream(stream_handle)) {
+        rm->unlockActiveStream();
+        return -EINVAL;
+    }
+    s = reinterpret_cast<Stream *>(stream_handle);
+    /* held until the op has run so a concurrent close can't free the stream */
+    status = rm->increaseStreamUserCounter(s);
+    if (0 != status) {
+        rm->unlockActiveStream();
+        PAL_ERR(LOG_TAG, "failed to increase stream user count");
+        return status;
+    }
+    rm->unlockActiveStream();
+
+    status = pool->attach(&s->asyncTask, pal_async_op_handler, s);
+    if (0 != status) {
+        PAL_ERR(LOG_TAG, "failed to attach async task, status %d", status);
+        release_async_op_user(s);
+        return status;
+    }
+
+    if (op == PAL_ASYNC_OP_SET_DEVICE) {
+        s->asyncMutex.lock();
+        s->asyncDevices.emplace_back(devices, devices + no_of_devices);
+        s->asyncMutex.unlock();
+    }
+
+    s->asyncPending++;
+    if (op == PAL_ASYNC_OP_CLOSE)
+        status = pool->postFinal(&s->asyncTask, op, pal_async_release);
+    else
+        status = pool->post(&s->asyncTask, op);
+    if (0 != status) {
+        PAL_ERR(LOG_TAG, "failed to queue async op %d, status %d", op, status);
+        s->asyncPending--;
+        if (op == PAL_ASYNC_OP_SET_DEVICE) {
+            s->asyncMutex.lock();
+            s->asyncDevices.pop_back();
+            s->asyncMutex.unlock();
+        }
+        release_async_op_user(s);
+    }
+
+    return status;
+}
+
+int32_t pal_stream_start_async(pal_stream_handle_t *stream_handle)
+{
+    PAL_DBG(LOG_TAG, "Stream handle :%pK", stream_handle);
+    return post_async_op(stream_handle, PAL_ASYNC_OP_START, 0, NULL);
+}
+
+int32_t pal_stream_stop_async(pal_stream_handle_t *stream_handle)
+{
+    PAL_DBG(LOG_TAG, "Stream handle :%pK", stream_handle);
+    return post_async_op(stream_handle, PAL_ASYNC_OP_STOP, 0, NULL);
+}
+
+int32_t pal_stream_set_device_async(pal_stream_handle_t *stream_handle,
+                           uint32_t no_of_devices, struct pal_device *devices)
+{
+    if (no_of_devices == 0 || !devices) {
+        PAL_ERR(LOG_TAG, "Invalid device status %d", -EINVAL);
+        return -EINVAL;
+    }
+
+    PAL_DBG(LOG_TAG, "Stream handle :%pK", stream_handle);
+    return post_async_op(stream_handle, PAL_ASYNC_OP_SET_DEVICE, no_of_devices, devices);
+}
+
+int32_t pal_stream_close_async(pal_stream_handle_t *stream_handle)
+{
+    PAL_DBG(LOG_TAG, "Stream handle :%pK", stream_handle);
+    return post_async_op(stream_handle, PAL_ASYNC_OP_CLOSE, 0, NULL);
+}
+
 int32_t pal_stream_get_tags_with_module_info(pal_stream_handle_t *stream_handle,
                            size_t *size, uint8_t *payload)
 {
@@ -63,6 +63,7 @@
 #include <iostream>
 #include <chrono>
 #include "ContextManager.h"
+#include "ThreadPolicy.h"
 #include <asps/asps_acm_api.h>
 #include "apm_api.h"
 
@@ -517,6 +518,8 @@ int32_t ContextManager::StopAndCloseProxyStream()
 
 void ContextManager::CommandThreadRunner(ContextManager& cm)
 {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_BACKGROUND, "pal_ctx_cmd");
+
     RequestCommand *request_command;
     int32_t rc = 0;
 
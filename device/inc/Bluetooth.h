@@ -41,6 +41,7 @@
 #include <bt_ble.h>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
 #include <system/audio.h>
 #include "Session.h"
 
@@ -253,12 +254,17 @@ private:
     /* member variables */
     uint8_t         a2dpRole;  // source or sink
     enum A2DP_STATE a2dpState;
+    /* signalled on state, suspend and reconfig changes, see waitDeviceReady */
+    std::mutex              readyMutex;
+    std::condition_variable readyCV;
+    uint32_t                readyGen;
     bool            isA2dpOffloadSupported;
     bool            support_bt_audio_pre_init;
     uint32_t        a2dpLatencyMode;
     uint32_t        codecLatency;
 
     uint32_t getLatency(uint32_t slatency);
+    void notifyReadyChange();
     int startPlayback();
     int stopPlayback();
     int startCapture();
@@ -281,6 +287,8 @@ public:
     int start();
     int stop();
     bool isDeviceReady() override;
+    /* false if the device did not become ready within timeoutMs */
+    bool waitDeviceReady(uint32_t timeoutMs);
     int32_t setDeviceParameter(uint32_t param_id, void *param) override;
     int32_t getDeviceParameter(uint32_t param_id, void **param) override;
 
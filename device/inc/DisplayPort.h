@@ -124,6 +124,14 @@ typedef struct edidAudioInfo {
     unsigned int  channelMask;
 } edidAudioInfo;
 
+/* parsed sink capabilities keyed by the raw SAD blob they came from */
+typedef struct edidCacheEntry {
+    uint32_t hash;
+    int32_t length;
+    unsigned char sad[MAX_SHORT_AUDIO_DESC_CNT * MIN_AUDIO_DESC_LENGTH];
+    edidAudioInfo info;
+} edidCacheEntry;
+
 class DisplayPort : public Device
 {
     uint32_t dp_controller;
@@ -165,6 +173,11 @@ public:
     static void updateChannelMask(edidAudioInfo* info);
     static void dumpEdidData(edidAudioInfo *info);
     static bool getSinkCaps(edidAudioInfo* info, char *edidData);
+    static uint32_t getEdidHash(const char *edidData);
+    static void loadEdidCache();
+    static void saveEdidCache();
+    static bool lookupEdidCache(const char *edidData, edidAudioInfo *info);
+    static void storeEdidCache(const char *edidData, edidAudioInfo *info);
     static int getDeviceChannelAllocation(int num_channels);
     bool isSupportedSR(edidAudioInfo* info, int sr);
     int getMaxChannel();
@@ -75,10 +75,9 @@ protected :
     static haptics_dev_prot_cal_state hapticsDevCalState;
     haptics_dev_prot_proc_state hapticsDevProcessingState;
     int *devTempList;
-    static bool isHapDevInUse;
+    std::vector<struct mixer_ctl *> devTempCtls;
     static bool calThrdCreated;
     static bool isDynamicCalTriggered;
-    static struct timespec devLastTimeUsed;
     static struct mixer *virtMixer;
     static struct mixer *hwMixer;
     static struct pcm *rxPcm;
@@ -97,9 +96,9 @@ private :
 public:
     static std::thread mCalThread;
     static std::condition_variable cv;
-    static std::mutex cvMutex;
     std::mutex deviceMutex;
     static std::mutex calibrationMutex;
+    static CalibrationScheduler calScheduler;
     void HapticsDevCalibrationThread();
     int getDevTemperature(int haptics_dev_pos);
     void HapticsDevCalibrateWait();
@@ -74,6 +74,7 @@
 #include <thread>
 #include<vector>
 #include "apm_api.h"
+#include "CalibrationScheduler.h"
 
 class Device;
 
@@ -141,11 +142,10 @@ protected :
     static speaker_prot_cal_state spkrCalState;
     spkr_prot_proc_state spkrProcessingState;
     int *spkerTempList;
-    static bool isSpkrInUse;
+    std::vector<struct mixer_ctl *> spkrTempCtls;
     static bool calThrdCreated;
     static bool isDynamicCalTriggered;
     static bool viTxSetupThrdCreated;
-    static struct timespec spkrLastTimeUsed;
     static struct mixer *virtMixer;
     static struct mixer *hwMixer;
     static struct pcm *rxPcm;
@@ -170,9 +170,9 @@ public:
     static std::thread mCalThread;
     static std::thread viTxSetupThread;
     static std::condition_variable cv;
-    static std::mutex cvMutex;
     std::mutex deviceMutex;
     static std::mutex calibrationMutex;
+    static CalibrationScheduler calScheduler;
     void spkrCalibrationThread();
     int getSpeakerTemperature(int spkr_pos);
     void spkrCalibrateWait();
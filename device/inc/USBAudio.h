@@ -72,6 +72,8 @@
 #include <vector>
 #include <system/audio.h>
 #include <map>
+#include <mutex>
+#include <string>
 
 #define USB_BUFF_SIZE           4096
 #define CHANNEL_NUMBER_STR      "Channels: "
@@ -96,6 +98,26 @@ typedef enum usb_usecase_type{
     USB_PLAYBACK,
 } usb_usecase_type_t;
 
+class USBDeviceConfig;
+
+/* one row per (Altset, rate), sorted by type/bit width/channels/rate */
+struct usb_profile_entry {
+    uint32_t type;
+    uint32_t bit_width;
+    uint32_t channels;
+    uint32_t sample_rate;
+    unsigned long service_interval_us;
+    size_t profile_idx;
+};
+
+/* parsed stream0 capability of one usb card, shared across reconnects */
+struct usb_capability_cache_entry {
+    std::string usbid;
+    int status[2] = {-ENOENT, -ENOENT};
+    int endian[2] = {0};
+    std::vector<std::shared_ptr<USBDeviceConfig>> profiles[2];
+};
+
 // one card supports multiple devices
 class USBDeviceConfig {
 protected:
@@ -124,6 +146,7 @@ public:
     int updateBestChInfo(struct pal_channel_info *requested_ch_info,
                          struct pal_channel_info *best);
     int getServiceInterval(const char *interval_str_start);
+    const std::vector<unsigned int>& getRates() { return rates_; };
     static const unsigned int supported_sample_rates_[MAX_SAMPLE_RATE_SIZE];
     void setJackStatus(bool jack_status);
     bool getJackStatus();
@@ -137,7 +160,18 @@ protected:
     std::multimap<uint32_t, std::shared_ptr<USBDeviceConfig>> format_list_map;
     std::vector <std::shared_ptr<USBDeviceConfig>> usb_device_config_list_;
     unsigned int usb_supported_sample_rates_mask_[2] = {0};
+    std::vector<usb_profile_entry> profile_table_;
+    static std::map<std::pair<int, int>, usb_capability_cache_entry> capability_cache_;
+    static std::mutex capability_cache_mutex_;
     void usb_info_dump(char* read_buf, int type);
+    int parseCapability(usb_usecase_type_t type, char *read_buf,
+                        usb_capability_cache_entry &entry);
+    int loadCapability(struct pal_usb_device_address addr,
+                       usb_capability_cache_entry &entry);
+    void buildProfileTable();
+    bool findProfile(uint32_t type, uint32_t bit_width, uint32_t channels,
+                     std::vector<usb_profile_entry>::iterator *first,
+                     std::vector<usb_profile_entry>::iterator *last);
 public:
     USBCardConfig(struct pal_usb_device_address address);
     bool isConfigCached(struct pal_usb_device_address addr);
@@ -161,6 +195,8 @@ public:
     bool isCaptureProfileSupported();
     bool readDefaultJackStatus(bool is_playback);
     bool getJackConnectionStatus (int usb_card, const char* suffix);
+    static std::string readUsbId(int usb_card);
+    static void invalidateCapability(int usb_card);
 };
 
 class USB : public Device
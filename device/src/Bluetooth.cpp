@@ -49,12 +49,15 @@
 #include <sstream>
 #include <string>
 #include <regex>
+#include <chrono>
 #include <system/audio.h>
 
 #define PARAM_ID_RESET_PLACEHOLDER_MODULE 0x08001173
 #define BT_IPC_SOURCE_LIB                 "btaudio_offload_if.so"
 #define BT_IPC_SOURCE_LIB2_NAME           "libbthost_if.so"
 #define BT_IPC_SINK_LIB                   "libbthost_if_sink.so"
+/* BT stack readiness is not signalled to PAL, recheck it at this period */
+#define A2DP_READY_POLL_MS                10
 #define MIXER_SET_FEEDBACK_CHANNEL        "BT set feedback channel"
 #define MIXER_SET_CODEC_TYPE              "BT codec type"
 #define BT_SLIMBUS_CLK_STR                "BT SLIMBUS CLK SRC"
@@ -1284,7 +1287,8 @@ audio_source_set_latency_mode_api_t BtA2dp::audio_source_set_latency_mode_api =
 
 BtA2dp::BtA2dp(struct pal_device *device, std::shared_ptr<ResourceManager> Rm)
       : Bluetooth(device, Rm),
-        a2dpState(A2DP_STATE_DISCONNECTED)
+        a2dpState(A2DP_STATE_DISCONNECTED),
+        readyGen(0)
 {
     a2dpRole = ((device->id == PAL_DEVICE_IN_BLUETOOTH_A2DP) || (device->id == PAL_DEVICE_IN_BLUETOOTH_BLE)) ? SINK : SOURCE;
     codecType = ((device->id == PAL_DEVICE_IN_BLUETOOTH_A2DP) || (device->id == PAL_DEVICE_IN_BLUETOOTH_BLE)) ? DEC : ENC;
@@ -1776,6 +1780,7 @@ int BtA2dp::startPlayback()
         }
 
         a2dpState = A2DP_STATE_STARTED;
+        notifyReadyChange();
     } else {
         /* Update Device GKV based on Already received encoder. */
         /* This is required for getting tagged module info in session class. */
@@ -1876,6 +1881,38 @@ bool BtA2dp::isDeviceReady()
     return ret;
 }
 
+void BtA2dp::notifyReadyChange()
+{
+    std::lock_guard<std::mutex> lock(readyMutex);
+    readyGen++;
+    readyCV.notify_all();
+}
+
+bool BtA2dp::waitDeviceReady(uint32_t timeoutMs)
+{
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeoutMs);
+    uint32_t gen;
+
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            gen = readyGen;
+        }
+        /* queried unlocked, it calls into the BT stack */
+        if (isDeviceReady())
+            return true;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+            return false;
+        std::unique_lock<std::mutex> lock(readyMutex);
+        readyCV.wait_until(lock, std::min(deadline,
+                           now + std::chrono::milliseconds(A2DP_READY_POLL_MS)),
+                           [&] { return readyGen != gen; });
+    }
+}
+
 int BtA2dp::startCapture()
 {
     int ret = 0;
@@ -1990,6 +2027,7 @@ int BtA2dp::startCapture()
 
     a2dpState = A2DP_STATE_STARTED;
     totalActiveSessionRequests++;
+    notifyReadyChange();
 
     PAL_DBG(LOG_TAG, "start A2DP sink total active sessions :%d",
                       totalActiveSessionRequests);
@@ -2290,6 +2328,7 @@ int32_t BtA2dp::setDeviceParameter(uint32_t param_id, void *param)
     }
 
 exit:
+    notifyReadyChange();
     return status;
 }
 
@@ -55,6 +55,12 @@ enum {
  */
 #define MAX_SAD_BLOCKS      10
 #define SAD_BLOCK_SIZE      3
+#define MAX_EDID_CACHE_ENTRIES 16
+#define EDID_CACHE_MAGIC    0x45444943
+#define EDID_CACHE_VERSION  1
+#ifndef PAL_EDID_CACHE_PATH
+#define PAL_EDID_CACHE_PATH "/data/vendor/audio/edid_audio_cache.bin"
+#endif
 #define ACK_ENABLE      "Ack_Enable"
 #define CONNECT         "Connect"
 #define DISCONNECT      "Disconnect"
@@ -65,6 +71,18 @@ static struct extDispState {
     int type = EXT_DISPLAY_TYPE_NONE;
 } extDisp[MAX_CONTROLLERS][MAX_STREAMS_PER_CONTROLLER];
 
+struct edidCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entrySize;
+    uint32_t count;
+};
+
+/* most recently used sink last */
+static std::vector<edidCacheEntry> edidCache;
+static bool edidCacheLoaded = false;
+static std::mutex edidCacheMutex;
+
 std::shared_ptr<Device> DisplayPort::objRx = nullptr;
 std::shared_ptr<Device> DisplayPort::objTx = nullptr;
 
@@ -423,7 +441,12 @@ int DisplayPort::init(pal_param_device_connection_t device_conn)
 int DisplayPort::deinit(pal_param_device_connection_t device_conn __unused)
 {
     updateAudioAckState(EXT_DISPLAY_PLUG_STATUS_NOTIFY_DISCONNECT, dp_controller, dp_stream);
-    //To-Do : Have to invalidate the cahed EDID
+    /*
+     * The next sink may be a different display, so re-read its EDID on
+     * connect. Known displays are resolved from the EDID cache.
+     */
+    if (getDisplayPortCtlIndex(dp_controller, dp_stream) >= 0)
+        extDisp[dp_controller][dp_stream].valid = false;
     return 0;
 }
 
@@ -654,9 +677,14 @@ int DisplayPort::getEdidInfo(struct audio_mixer *mixer, int controller, int stre
 
     PAL_VERBOSE(LOG_TAG," received edid data: count %d", edidData[0]);
 
-    if (!getSinkCaps((struct edidAudioInfo *)state->edidInfo, edidData)) {
-        PAL_ERR(LOG_TAG," Failed to get extn disp sink capabilities");
-        goto fail;
+    if (lookupEdidCache(edidData, (struct edidAudioInfo *)state->edidInfo)) {
+        PAL_DBG(LOG_TAG," using cached sink capabilities");
+    } else {
+        if (!getSinkCaps((struct edidAudioInfo *)state->edidInfo, edidData)) {
+            PAL_ERR(LOG_TAG," Failed to get extn disp sink capabilities");
+            goto fail;
+        }
+        storeEdidCache(edidData, (struct edidAudioInfo *)state->edidInfo);
     }
     state->valid = true;
     return 0;
@@ -675,6 +703,136 @@ void DisplayPort::cacheEdid(struct audio_mixer *mixer, int controller, int strea
     getEdidInfo(mixer, controller, stream);
 }
 
+/* FNV-1a over the length byte and the SAD blob */
+uint32_t DisplayPort::getEdidHash(const char *edidData)
+{
+    uint32_t hash = 2166136261u;
+    int length = (unsigned char)edidData[0];
+
+    for (int i = 0; i <= length; i++) {
+        hash ^= (unsigned char)edidData[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void DisplayPort::loadEdidCache()
+{
+    FILE *fp = NULL;
+    struct edidCacheHeader header;
+    edidCacheEntry entry;
+
+    edidCacheLoaded = true;
+    fp = fopen(PAL_EDID_CACHE_PATH, "rb");
+    if (!fp) {
+        PAL_DBG(LOG_TAG," no edid cache at %s", PAL_EDID_CACHE_PATH);
+        return;
+    }
+
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        header.magic != EDID_CACHE_MAGIC || header.version != EDID_CACHE_VERSION ||
+        header.entrySize != sizeof(edidCacheEntry) ||
+        header.count > MAX_EDID_CACHE_ENTRIES) {
+        PAL_ERR(LOG_TAG," ignoring stale or corrupt edid cache");
+        goto exit;
+    }
+
+    for (uint32_t i = 0; i < header.count; i++) {
+        if (fread(&entry, sizeof(entry), 1, fp) != 1)
+            break;
+        if (entry.length < 0 || entry.length > (int32_t)sizeof(entry.sad))
+            continue;
+        /* callers index audioBlocksArray by this count */
+        if (entry.info.audioBlocks < 0 || entry.info.audioBlocks > MAX_EDID_BLOCKS)
+            continue;
+        edidCache.push_back(entry);
+    }
+    PAL_DBG(LOG_TAG," loaded %zu cached edid entries", edidCache.size());
+
+exit:
+    fclose(fp);
+}
+
+void DisplayPort::saveEdidCache()
+{
+    FILE *fp = NULL;
+    std::string tmpPath = std::string(PAL_EDID_CACHE_PATH) + ".tmp";
+    struct edidCacheHeader header = {EDID_CACHE_MAGIC, EDID_CACHE_VERSION,
+                                     sizeof(edidCacheEntry), (uint32_t)edidCache.size()};
+
+    fp = fopen(tmpPath.c_str(), "wb");
+    if (!fp) {
+        PAL_ERR(LOG_TAG," unable to open %s, errno %d", tmpPath.c_str(), errno);
+        return;
+    }
+
+    if (fwrite(&header, sizeof(header), 1, fp) != 1 ||
+        (edidCache.size() &&
+         fwrite(edidCache.data(), sizeof(edidCacheEntry), edidCache.size(), fp) !=
+         edidCache.size())) {
+        PAL_ERR(LOG_TAG," failed to write edid cache");
+        fclose(fp);
+        remove(tmpPath.c_str());
+        return;
+    }
+    fclose(fp);
+
+    if (rename(tmpPath.c_str(), PAL_EDID_CACHE_PATH))
+        PAL_ERR(LOG_TAG," failed to commit edid cache, errno %d", errno);
+}
+
+bool DisplayPort::lookupEdidCache(const char *edidData, edidAudioInfo *info)
+{
+    std::lock_guard<std::mutex> lock(edidCacheMutex);
+    uint32_t hash = getEdidHash(edidData);
+    int32_t length = (unsigned char)edidData[0];
+
+    if (!info)
+        return false;
+
+    if (!edidCacheLoaded)
+        loadEdidCache();
+
+    for (auto it = edidCache.begin(); it != edidCache.end(); it++) {
+        if (it->hash != hash || it->length != length ||
+            memcmp(it->sad, &edidData[1], length))
+            continue;
+
+        *info = it->info;
+        /* keep recently seen sinks at the tail */
+        if (it + 1 != edidCache.end()) {
+            edidCacheEntry entry = *it;
+            edidCache.erase(it);
+            edidCache.push_back(entry);
+        }
+        PAL_DBG(LOG_TAG," edid cache hit, hash 0x%x", hash);
+        dumpEdidData(info);
+        return true;
+    }
+    return false;
+}
+
+void DisplayPort::storeEdidCache(const char *edidData, edidAudioInfo *info)
+{
+    std::lock_guard<std::mutex> lock(edidCacheMutex);
+    edidCacheEntry entry;
+    int32_t length = (unsigned char)edidData[0];
+
+    if (!info || length > (int32_t)sizeof(entry.sad))
+        return;
+
+    memset(&entry, 0, sizeof(entry));
+    entry.hash = getEdidHash(edidData);
+    entry.length = length;
+    memcpy(entry.sad, &edidData[1], length);
+    entry.info = *info;
+
+    if (edidCache.size() >= MAX_EDID_CACHE_ENTRIES)
+        edidCache.erase(edidCache.begin());
+    edidCache.push_back(entry);
+    saveEdidCache();
+}
+
 int32_t DisplayPort::isSampleRateSupported(uint32_t sampleRate)
 {
     int32_t rc = 0;
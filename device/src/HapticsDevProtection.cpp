@@ -81,13 +81,11 @@
 
 std::thread HapticsDevProtection::mCalThread;
 std::condition_variable HapticsDevProtection::cv;
-std::mutex HapticsDevProtection::cvMutex;
 std::mutex HapticsDevProtection::calibrationMutex;
+CalibrationScheduler HapticsDevProtection::calScheduler("HapticsDevice", MIN_HAPTICS_DEV_IDLE_SEC);
 
-bool HapticsDevProtection::isHapDevInUse;
 bool HapticsDevProtection::calThrdCreated;
 bool HapticsDevProtection::isDynamicCalTriggered = false;
-struct timespec HapticsDevProtection::devLastTimeUsed;
 struct mixer *HapticsDevProtection::virtMixer;
 struct mixer *HapticsDevProtection::hwMixer;
 haptics_dev_prot_cal_state HapticsDevProtection::hapticsDevCalState;
@@ -121,41 +119,25 @@ std::string getDefaultHapticsDevTempCtrl(uint8_t haptics_dev_pos)
  */
 bool HapticsDevProtection::isHapticsDevInUse(unsigned long *sec)
 {
-    struct timespec temp;
-    PAL_DBG(LOG_TAG, "Enter");
+    bool inUse;
 
     if (!sec) {
         PAL_ERR(LOG_TAG, "Improper argument");
         return false;
     }
 
-    if (isHapDevInUse) {
-        PAL_INFO(LOG_TAG, " HapticsDevice in use");
-        *sec = 0;
-        return true;
-    } else {
-        PAL_INFO(LOG_TAG, " HapticsDevice not in use");
-        clock_gettime(CLOCK_BOOTTIME, &temp);
-        *sec = temp.tv_sec - devLastTimeUsed.tv_sec;
-    }
+    inUse = calScheduler.isInUse(sec);
+    PAL_DBG(LOG_TAG, " HapticsDevice %s, idle time %ld", inUse ? "in use" : "not in use", *sec);
 
-    PAL_DBG(LOG_TAG, "Idle time %ld", *sec);
-
-    return false;
+    return inUse;
 }
 
-/* Function to set status of HapticsDevice */
+/* Function to set status of HapticsDevice, wakes up the calibration thread */
 void HapticsDevProtection::HapticsDevProtSetDevStatus(bool enable)
 {
     PAL_DBG(LOG_TAG, "Enter");
 
-    if (enable)
-        isHapDevInUse = true;
-    else {
-        isHapDevInUse = false;
-        clock_gettime(CLOCK_BOOTTIME, &devLastTimeUsed);
-        PAL_INFO(LOG_TAG, " HapticsDevice used last time %ld", devLastTimeUsed.tv_sec);
-    }
+    calScheduler.setInUse(enable);
 
     PAL_DBG(LOG_TAG, "Exit");
 }
@@ -163,9 +145,7 @@ void HapticsDevProtection::HapticsDevProtSetDevStatus(bool enable)
 /* Wait function for WAKEUP_MIN_IDLE_CHECK  */
 void HapticsDevProtection::HapticsDevCalibrateWait()
 {
-    std::unique_lock<std::mutex> lock(cvMutex);
-    cv.wait_for(lock,
-            std::chrono::milliseconds(WAKEUP_MIN_IDLE_CHECK));
+    calScheduler.sleepFor(WAKEUP_MIN_IDLE_CHECK);
 }
 
 // Callback from DSP for Ressistance value
@@ -848,7 +828,7 @@ int HapticsDevProtection::HapticsDevStartCalibration()
             PAL_DBG(LOG_TAG, "Calibration is not done");
             hapticsDevCalState = HAPTICS_DEV_NOT_CALIBRATED;
             // reset the timer for retry
-            clock_gettime(CLOCK_BOOTTIME, &devLastTimeUsed);
+            calScheduler.restartIdleWindow();
         }
     }
 
@@ -907,13 +887,13 @@ exit:
         // for the unlock. So notify it.
         PAL_DBG(LOG_TAG, "Unlocked due to processing mode");
         hapticsDevCalState = HAPTICS_DEV_NOT_CALIBRATED;
-        clock_gettime(CLOCK_BOOTTIME, &devLastTimeUsed);
+        calScheduler.restartIdleWindow();
         cv.notify_all();
     }
 
     if (ret != 0) {
         // Error happened. Reset timer
-        clock_gettime(CLOCK_BOOTTIME, &devLastTimeUsed);
+        calScheduler.restartIdleWindow();
     }
 
     if(builder) {
@@ -933,101 +913,70 @@ exit:
 void HapticsDevProtection::getHapticsDevTemperatureList()
 {
     int i = 0;
-    int value;
+    std::string mixer_ctl_name;
     PAL_DBG(LOG_TAG, "Enter  HapticsDevice Get Temperature List");
 
-    for(i = 0; i < numberOfChannels; i++) {
-         value = getDevTemperature(i);
-         PAL_DBG(LOG_TAG, "Temperature %d ", value);
-         devTempList[i] = value;
+    /* resolve the temperature controls once and read them in one pass */
+    if (devTempCtls.size() != numberOfChannels) {
+        devTempCtls.clear();
+        for (i = 0; i < numberOfChannels; i++) {
+            mixer_ctl_name = getDefaultHapticsDevTempCtrl(i);
+            devTempCtls.push_back(mixer_get_ctl_by_name(hwMixer, mixer_ctl_name.c_str()));
+            if (!devTempCtls.back())
+                PAL_ERR(LOG_TAG, "Invalid mixer control: %s", mixer_ctl_name.c_str());
+        }
+    }
+
+    for (i = 0; i < numberOfChannels; i++) {
+        devTempList[i] = devTempCtls[i] ?
+                mixer_ctl_get_value(devTempCtls[i], 0) : -EINVAL;
+        PAL_DBG(LOG_TAG, "Temperature %d ", devTempList[i]);
     }
     PAL_DBG(LOG_TAG, "Exit  HapticsDevice Get Temperature List");
 }
 
 void HapticsDevProtection::HapticsDevCalibrationThread()
 {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_BACKGROUND, "pal_haptics_cal");
+
     unsigned long sec = 0;
-    bool proceed = false;
     int i;
 
     while (!threadExit) {
-        PAL_DBG(LOG_TAG, "Inside calibration while loop");
-        proceed = false;
-        if (isHapticsDevInUse(&sec)) {
-            PAL_DBG(LOG_TAG, "HapticsDev in use. Wait for proper time");
-            HapticsDevCalibrateWait();
-            PAL_DBG(LOG_TAG, "Waiting done");
-            continue;
-        }
-        else {
-            PAL_DBG(LOG_TAG, "HapticsDev not in use");
-            if (isDynamicCalTriggered) {
-                PAL_DBG(LOG_TAG, "Dynamic Calibration triggered");
-            }
-            else if (sec < minIdleTime) {
-                PAL_DBG(LOG_TAG, "HapticsDev not idle for minimum time. %lu", sec);
+        /* woken by HapticsDevProtSetDevStatus transitions or the idle deadline */
+        PAL_DBG(LOG_TAG, "Waiting for HapticsDev idle window");
+        calScheduler.waitForIdleWindow(isDynamicCalTriggered);
+
+        PAL_DBG(LOG_TAG, "Getting temperature of HapticsDev");
+        getHapticsDevTemperatureList();
+
+        for (i = 0; i < numberOfChannels; i++) {
+            if ((devTempList[i] != -EINVAL) &&
+                (devTempList[i] < TZ_TEMP_MIN_THRESHOLD ||
+                 devTempList[i] > TZ_TEMP_MAX_THRESHOLD)) {
+                PAL_ERR(LOG_TAG, "Temperature out of range. Retry");
                 HapticsDevCalibrateWait();
-                PAL_DBG(LOG_TAG, "Waited for HapticsDev to be idle for min time");
                 continue;
             }
-            proceed = true;
-        }
-
-        if (proceed) {
-            PAL_DBG(LOG_TAG, "Getting temperature of HapticsDev");
-            getHapticsDevTemperatureList();
-
-            for (i = 0; i < numberOfChannels; i++) {
-                if ((devTempList[i] != -EINVAL) &&
-                    (devTempList[i] < TZ_TEMP_MIN_THRESHOLD ||
-                     devTempList[i] > TZ_TEMP_MAX_THRESHOLD)) {
-                    PAL_ERR(LOG_TAG, "Temperature out of range. Retry");
-                    HapticsDevCalibrateWait();
-                    continue;
-                }
-            }
-            for (i = 0; i < numberOfChannels; i++) {
-                // Converting to Q6 format
-                devTempList[i] = (devTempList[i]*(1<<6));
-            }
         }
-        else {
-            continue;
+        for (i = 0; i < numberOfChannels; i++) {
+            // Converting to Q6 format
+            devTempList[i] = (devTempList[i]*(1<<6));
         }
 
         // Check whether HapticsDevice  was in use in the meantime when temperature
         // was being read.
-        proceed = false;
-        if (isHapticsDevInUse(&sec)) {
-            PAL_DBG(LOG_TAG, " HapticsDevice in use. Wait for proper time");
-            HapticsDevCalibrateWait();
-            PAL_DBG(LOG_TAG, "Waiting done");
+        if (isHapticsDevInUse(&sec) ||
+            (!isDynamicCalTriggered && sec < minIdleTime)) {
+            PAL_DBG(LOG_TAG, " HapticsDevice used while reading temperature");
             continue;
         }
-        else {
-            PAL_DBG(LOG_TAG, " HapticsDevice not in use");
-            if (isDynamicCalTriggered) {
-                PAL_DBG(LOG_TAG, "Dynamic calibration triggered");
-            }
-            else if (sec < minIdleTime) {
-                PAL_DBG(LOG_TAG, " HapticsDevice not idle for minimum time. %lu", sec);
-                HapticsDevCalibrateWait();
-                PAL_DBG(LOG_TAG, "Waited for HapticsDevice to be idle for min time");
-                continue;
-            }
-            proceed = true;
-        }
 
-        if (proceed) {
-            // Start calibrating the HapticsDevice.
-            PAL_DBG(LOG_TAG, " HapticsDevice not in use, start calibration");
-            HapticsDevStartCalibration();
-            if (hapticsDevCalState == HAPTICS_DEV_CALIBRATED) {
-                threadExit = true;
-            }
-        }
-        else {
-            continue;
+        // Start calibrating the HapticsDevice.
+        PAL_DBG(LOG_TAG, " HapticsDevice not in use, start calibration");
+        HapticsDevStartCalibration();
+        if (hapticsDevCalState == HAPTICS_DEV_CALIBRATED) {
+            threadExit = true;
         }
     }
     isDynamicCalTriggered = false;
@@ -1043,6 +992,7 @@ HapticsDevProtection::HapticsDevProtection(struct pal_device *device,
     FILE *fp;
 
     minIdleTime = MIN_HAPTICS_DEV_IDLE_SEC;
+    calScheduler.setMinIdleTime(minIdleTime);
 
     rm = Rm;
 
@@ -1056,8 +1006,6 @@ HapticsDevProtection::HapticsDevProtection(struct pal_device *device,
     hapticsDevCalState = HAPTICS_DEV_NOT_CALIBRATED;
     hapticsDevProcessingState = HAPTICS_DEV_PROCESSING_IN_IDLE;
 
-    isHapDevInUse = false;
-
     rm->getDeviceInfo(PAL_DEVICE_OUT_HAPTICS_DEVICE, PAL_STREAM_PROXY, "", &devinfo);
     numberOfChannels = devinfo.channels;
     PAL_DBG(LOG_TAG, "Number of Channels %d", numberOfChannels);
@@ -1066,8 +1014,8 @@ HapticsDevProtection::HapticsDevProtection(struct pal_device *device,
     PAL_DBG(LOG_TAG, "Number of Channels for VI path is %d", vi_device.channels);
 
     devTempList = new int [numberOfChannels];
-    // Get current time
-    clock_gettime(CLOCK_BOOTTIME, &devLastTimeUsed);
+    // Idle window starts now
+    calScheduler.setInUse(false);
 
     // Getting mixer controls from Resource Manager
     status = rm->getVirtualAudioMixer(&virtMixer);
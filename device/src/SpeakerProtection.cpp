@@ -120,14 +120,12 @@
 std::thread SpeakerProtection::mCalThread;
 std::thread SpeakerProtection::viTxSetupThread;
 std::condition_variable SpeakerProtection::cv;
-std::mutex SpeakerProtection::cvMutex;
 std::mutex SpeakerProtection::calibrationMutex;
+CalibrationScheduler SpeakerProtection::calScheduler("Speaker", MIN_SPKR_IDLE_SEC);
 
-bool SpeakerProtection::isSpkrInUse;
 bool SpeakerProtection::calThrdCreated;
 bool SpeakerProtection::viTxSetupThrdCreated;
 bool SpeakerProtection::isDynamicCalTriggered = false;
-struct timespec SpeakerProtection::spkrLastTimeUsed;
 struct mixer *SpeakerProtection::virtMixer;
 struct mixer *SpeakerProtection::hwMixer;
 speaker_prot_cal_state SpeakerProtection::spkrCalState;
@@ -188,41 +186,25 @@ int SpeakerProtection::updateVICustomPayload(void *payload, size_t size)
  */
 bool SpeakerProtection::isSpeakerInUse(unsigned long *sec)
 {
-    struct timespec temp;
-    PAL_DBG(LOG_TAG, "Enter");
+    bool inUse;
 
     if (!sec) {
         PAL_ERR(LOG_TAG, "Improper argument");
         return false;
     }
 
-    if (isSpkrInUse) {
-        PAL_INFO(LOG_TAG, "Speaker in use");
-        *sec = 0;
-        return true;
-    } else {
-        PAL_INFO(LOG_TAG, "Speaker not in use");
-        clock_gettime(CLOCK_BOOTTIME, &temp);
-        *sec = temp.tv_sec - spkrLastTimeUsed.tv_sec;
-    }
-
-    PAL_DBG(LOG_TAG, "Idle time %ld", *sec);
+    inUse = calScheduler.isInUse(sec);
+    PAL_DBG(LOG_TAG, "Speaker %s, idle time %ld", inUse ? "in use" : "not in use", *sec);
 
-    return false;
+    return inUse;
 }
 
-/* Function to set status of speaker */
+/* Function to set status of speaker, wakes up the calibration thread */
 void SpeakerProtection::spkrProtSetSpkrStatus(bool enable)
 {
     PAL_DBG(LOG_TAG, "Enter");
 
-    if (enable)
-        isSpkrInUse = true;
-    else {
-        isSpkrInUse = false;
-        clock_gettime(CLOCK_BOOTTIME, &spkrLastTimeUsed);
-        PAL_INFO(LOG_TAG, "Speaker used last time %ld", spkrLastTimeUsed.tv_sec);
-    }
+    calScheduler.setInUse(enable);
 
     PAL_DBG(LOG_TAG, "Exit");
 }
@@ -230,9 +212,7 @@ void SpeakerProtection::spkrProtSetSpkrStatus(bool enable)
 /* Wait function for WAKEUP_MIN_IDLE_CHECK  */
 void SpeakerProtection::spkrCalibrateWait()
 {
-    std::unique_lock<std::mutex> lock(cvMutex);
-    cv.wait_for(lock,
-            std::chrono::milliseconds(WAKEUP_MIN_IDLE_CHECK));
+    calScheduler.sleepFor(WAKEUP_MIN_IDLE_CHECK);
 }
 
 // Callback from DSP for Ressistance value
@@ -998,7 +978,7 @@ int SpeakerProtection::spkrStartCalibration()
             PAL_DBG(LOG_TAG, "Calibration is not done");
             spkrCalState = SPKR_NOT_CALIBRATED;
             // reset the timer for retry
-            clock_gettime(CLOCK_BOOTTIME, &spkrLastTimeUsed);
+            calScheduler.restartIdleWindow();
         }
         dspEventReceived = true;
     }
@@ -1098,13 +1078,13 @@ exit:
         // for the unlock. So notify it.
         PAL_DBG(LOG_TAG, "Unlocked due to processing mode");
         spkrCalState = SPKR_NOT_CALIBRATED;
-        clock_gettime(CLOCK_BOOTTIME, &spkrLastTimeUsed);
+        calScheduler.restartIdleWindow();
     }
     cv.notify_all();
 
     if (ret != 0) {
         // Error happened. Reset timer
-        clock_gettime(CLOCK_BOOTTIME, &spkrLastTimeUsed);
+        calScheduler.restartIdleWindow();
     }
 
     if(builder) {
@@ -1124,78 +1104,48 @@ exit:
 void SpeakerProtection::getSpeakerTemperatureList()
 {
     int i = 0;
-    int value;
+    std::string mixer_ctl_name;
     PAL_DBG(LOG_TAG, "Enter Speaker Get Temperature List");
 
-    for(i = 0; i < numberOfChannels; i++) {
-         value = getSpeakerTemperature(i);
-         PAL_DBG(LOG_TAG, "Temperature %d ", value);
-         spkerTempList[i] = value;
+    /* resolve the temperature controls once and read them in one pass */
+    if (spkrTempCtls.size() != numberOfChannels) {
+        spkrTempCtls.clear();
+        for (i = 0; i < numberOfChannels; i++) {
+            mixer_ctl_name = rm->getSpkrTempCtrl(i);
+            if (mixer_ctl_name.empty())
+                mixer_ctl_name = getDefaultSpkrTempCtrl(i);
+            spkrTempCtls.push_back(mixer_get_ctl_by_name(hwMixer, mixer_ctl_name.c_str()));
+            if (!spkrTempCtls.back())
+                PAL_ERR(LOG_TAG, "Invalid mixer control: %s", mixer_ctl_name.c_str());
+        }
+    }
+
+    for (i = 0; i < numberOfChannels; i++) {
+        spkerTempList[i] = spkrTempCtls[i] ?
+                mixer_ctl_get_value(spkrTempCtls[i], 0) : -EINVAL;
+        PAL_DBG(LOG_TAG, "Temperature %d ", spkerTempList[i]);
     }
     PAL_DBG(LOG_TAG, "Exit Speaker Get Temperature List");
 }
 
 void SpeakerProtection::spkrCalibrationThread()
 {
-    unsigned long sec = 0;
-    bool proceed = false;
-    int i;
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_BACKGROUND, "pal_spkr_cal");
 
     while (!threadExit) {
-        PAL_DBG(LOG_TAG, "Inside calibration while loop");
-        proceed = false;
-        if (isSpeakerInUse(&sec)) {
-            PAL_DBG(LOG_TAG, "Speaker in use. Wait for proper time");
-            spkrCalibrateWait();
-            PAL_DBG(LOG_TAG, "Waiting done");
-            continue;
-        }
-        else {
-            PAL_DBG(LOG_TAG, "Speaker not in use");
-            if (isDynamicCalTriggered) {
-                PAL_DBG(LOG_TAG, "Dynamic Calibration triggered");
-            }
-            else if (sec < minIdleTime) {
-                PAL_DBG(LOG_TAG, "Speaker not idle for minimum time. %lu", sec);
-                spkrCalibrateWait();
-                PAL_DBG(LOG_TAG, "Waited for speaker to be idle for min time");
-                continue;
-            }
-            proceed = true;
-        }
-        // Check whether speaker was in use in the meantime when temperature
-        // was being read.
-        proceed = false;
-        if (isSpeakerInUse(&sec)) {
-            PAL_DBG(LOG_TAG, "Speaker in use. Wait for proper time");
-            spkrCalibrateWait();
-            PAL_DBG(LOG_TAG, "Waiting done");
-            continue;
-        }
-        else {
-            PAL_DBG(LOG_TAG, "Speaker not in use");
-            if (isDynamicCalTriggered) {
-                PAL_DBG(LOG_TAG, "Dynamic calibration triggered");
-            }
-            else if (sec < minIdleTime) {
-                PAL_DBG(LOG_TAG, "Speaker not idle for minimum time. %lu", sec);
-                spkrCalibrateWait();
-                PAL_DBG(LOG_TAG, "Waited for speaker to be idle for min time");
-                continue;
-            }
-            proceed = true;
-        }
+        /*
+         * Sleeps until the speaker has been idle for minIdleTime. In use/idle
+         * transitions from spkrProtSetSpkrStatus wake the thread, so there
+         * is no periodic wakeup while waiting.
+         */
+        PAL_DBG(LOG_TAG, "Waiting for speaker idle window");
+        calScheduler.waitForIdleWindow(isDynamicCalTriggered);
 
-        if (proceed) {
-            // Start calibrating the speakers.
-            PAL_DBG(LOG_TAG, "Speaker not in use, start calibration");
-            spkrStartCalibration();
-            if (spkrCalState == SPKR_CALIBRATED) {
-                threadExit = true;
-            }
-        }
-        else {
-            continue;
+        // Start calibrating the speakers.
+        PAL_DBG(LOG_TAG, "Speaker not in use, start calibration");
+        spkrStartCalibration();
+        if (spkrCalState == SPKR_CALIBRATED) {
+            threadExit = true;
         }
     }
     isDynamicCalTriggered = false;
@@ -1217,6 +1167,7 @@ SpeakerProtection::SpeakerProtection(struct pal_device *device,
         minIdleTime = ResourceManager::spQuickCalTime;
     else
         minIdleTime = MIN_SPKR_IDLE_SEC;
+    calScheduler.setMinIdleTime(minIdleTime);
 
     rm = Rm;
 
@@ -1230,8 +1181,6 @@ SpeakerProtection::SpeakerProtection(struct pal_device *device,
     spkrCalState = SPKR_NOT_CALIBRATED;
     spkrProcessingState = SPKR_PROCESSING_IN_IDLE;
 
-    isSpkrInUse = false;
-
     calibrationCallbackStatus = 0;
     mDspCallbackRcvd = false;
 
@@ -1246,8 +1195,8 @@ SpeakerProtection::SpeakerProtection(struct pal_device *device,
     PAL_DBG(LOG_TAG, "Number of Channels for CPS path is %d", cps_device.channels);
 
     spkerTempList = new int [numberOfChannels];
-    // Get current time
-    clock_gettime(CLOCK_BOOTTIME, &spkrLastTimeUsed);
+    // Idle window starts now
+    calScheduler.setInUse(false);
 
     // Getting mixture controls from Resource Manager
     status = rm->getVirtualAudioMixer(&virtMixer);
@@ -1425,6 +1374,8 @@ exit:
 
 int SpeakerProtection::viTxSetupThreadLoop()
 {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_BACKGROUND, "pal_spkr_vi");
+
     int ret = 0, dir = TX_HOSTLESS, flags, viParamId =0;
     std::shared_ptr<ResourceManager> rm;
     char mSndDeviceName_vi[128] = {0};
@@ -73,6 +73,8 @@
 #include "kvh2xml.h"
 #include <unistd.h>
 #include <fstream>
+#include <algorithm>
+#include <tuple>
 
 std::shared_ptr<Device> USB::objRx = nullptr;
 std::shared_ptr<Device> USB::objTx = nullptr;
@@ -271,6 +273,8 @@ int USB::init(pal_param_device_connection_t device_conn)
 
         if (ret == 0)
             usb_card_config_list_.push_back(sp);
+        else if (ret != -ENOENT)
+            USBCardConfig::invalidateCapability(device_conn.device_config.usb_addr.card_id);
 
         setVendorIdCkv(device_conn.device_config.usb_addr);
     } else {
@@ -328,15 +332,11 @@ int USB::usb_vendor_id_ckv_ = 0;
 void USB::setVendorIdCkv(struct pal_usb_device_address addr) {
     std::vector<std::string>::iterator it;
     std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
-    std::string vendor_id_usb;
+    std::string vendor_id_usb = USBCardConfig::readUsbId(addr.card_id);
     usb_vendor_id_ckv_ = 0;    //reset value to 0 to load default
-    std::ifstream in("/proc/asound/card"+std::to_string(addr.card_id)+"/usbid");
 
-    if(in.good()) {
-        if (getline(in, vendor_id_usb)) {
-            PAL_DBG(LOG_TAG, "USB_Vendor_ID of connected usb device is %s", vendor_id_usb.c_str());
-        }
-    }
+    if (!vendor_id_usb.empty())
+        PAL_DBG(LOG_TAG, "USB_Vendor_ID of connected usb device is %s", vendor_id_usb.c_str());
 
     if (vendor_id_usb.empty())
         goto done;
@@ -455,25 +455,70 @@ void USBCardConfig::setEndian(int endian){
 }
 
 void USBCardConfig::usb_info_dump(char* read_buf, int type) {
-    char* start = nullptr;
-    const char s[2] = "\n";
-    char* token;
-    char *tmp = nullptr;
+    const char* start = nullptr;
+    const char* end = nullptr;
 
     const char* direction = type == USB_PLAYBACK ? PLAYBACK_PROFILE_STR : CAPTURE_PROFILE_STR;
 
     start = strstr(read_buf, direction);
-    token = strtok_r(start, s, &tmp);
-    while (token != nullptr) {
-        PAL_DBG(LOG_TAG, "  %s", token);
-        token = strtok_r(nullptr, s, &tmp);
+    while (start != nullptr && *start != '\0') {
+        end = strchr(start, '\n');
+        if (end == nullptr) {
+            PAL_DBG(LOG_TAG, "  %s", start);
+            break;
+        }
+        if (end > start)
+            PAL_DBG(LOG_TAG, "  %.*s", (int)(end - start), start);
+        start = end + 1;
     }
 }
 
-int USBCardConfig::getCapability(usb_usecase_type_t type,
-                                        struct pal_usb_device_address addr) {
+static bool usbProfileLess(const usb_profile_entry &a, const usb_profile_entry &b)
+{
+    return std::tie(a.type, a.bit_width, a.channels, a.sample_rate) <
+           std::tie(b.type, b.bit_width, b.channels, b.sample_rate);
+}
+
+static bool usbProfileFormatLess(const usb_profile_entry &a, const usb_profile_entry &b)
+{
+    return std::tie(a.type, a.bit_width, a.channels) <
+           std::tie(b.type, b.bit_width, b.channels);
+}
+
+static bool usbProfileRateLess(const usb_profile_entry &a, uint32_t rate)
+{
+    return a.sample_rate < rate;
+}
+
+std::map<std::pair<int, int>, usb_capability_cache_entry> USBCardConfig::capability_cache_;
+std::mutex USBCardConfig::capability_cache_mutex_;
+
+std::string USBCardConfig::readUsbId(int usb_card)
+{
+    std::string usbid;
+    std::ifstream in("/proc/asound/card" + std::to_string(usb_card) + "/usbid");
+
+    if (in.good())
+        getline(in, usbid);
+
+    return usbid;
+}
+
+void USBCardConfig::invalidateCapability(int usb_card)
+{
+    std::lock_guard<std::mutex> lock(capability_cache_mutex_);
+
+    for (auto it = capability_cache_.begin(); it != capability_cache_.end();) {
+        if (it->first.first == usb_card)
+            it = capability_cache_.erase(it);
+        else
+            it++;
+    }
+}
+
+int USBCardConfig::parseCapability(usb_usecase_type_t type, char *read_buf,
+                                   usb_capability_cache_entry &entry) {
     int32_t size = 0;
-    FILE *fd = NULL;
     int32_t channels_no;
     char *str_start = NULL;
     char *str_end = NULL;
@@ -481,59 +526,19 @@ int USBCardConfig::getCapability(usb_usecase_type_t type,
     char *bit_width_start = NULL;
     char *rates_str_start = NULL;
     char *target = NULL;
-    char *read_buf = NULL;
     char *rates_str = NULL;
     char *interval_str_start = NULL;
-    char path[128];
     int ret = 0;
     char *bit_width_str = NULL;
-    size_t num_read = 0;
-    const char* suffix;
-    bool jack_status;
-    //std::shared_ptr<USBDeviceConfig> usb_device_info = nullptr;
-
     bool check = false;
 
-    memset(path, 0, sizeof(path));
-    PAL_INFO(LOG_TAG, "for %s", (type == USB_PLAYBACK) ?
-          PLAYBACK_PROFILE_STR : CAPTURE_PROFILE_STR);
-
-    ret = snprintf(path, sizeof(path), "/proc/asound/card%u/stream0",
-             addr.card_id);
-    if(ret < 0) {
-        PAL_ERR(LOG_TAG, "failed on snprintf (%d) to path %s\n", ret, path);
-        ret = -EINVAL;
-        goto done;
-    }
-
-    fd = fopen(path, "r");
-    if (!fd) {
-        PAL_ERR(LOG_TAG, "failed to open config file %s error: %d\n", path, errno);
-        ret = -EINVAL;
-        goto done;
-    }
-
-    read_buf = (char *)calloc(1, USB_BUFF_SIZE + 1);
-    if (!read_buf) {
-        PAL_ERR(LOG_TAG, "Failed to create read_buf");
-        ret = -ENOMEM;
-        goto done;
-    }
-
-    if ((num_read = fread(read_buf, 1, USB_BUFF_SIZE, fd)) < 0) {
-        PAL_ERR(LOG_TAG, "file read error");
-        goto done;
-    }
-    read_buf[num_read] = '\0';
-
     str_start = strstr(read_buf, ((type == USB_PLAYBACK) ?
                        PLAYBACK_PROFILE_STR : CAPTURE_PROFILE_STR));
     if (str_start == NULL) {
         PAL_INFO(LOG_TAG, "error %s section not found in usb config file",
                 ((type == USB_PLAYBACK) ?
                PLAYBACK_PROFILE_STR : CAPTURE_PROFILE_STR));
-        ret = -ENOENT;
-        goto done;
+        return -ENOENT;
     }
 
     str_end = strstr(read_buf, ((type == USB_PLAYBACK) ?
@@ -583,7 +588,7 @@ int USBCardConfig::getCapability(usb_usecase_type_t type,
             const char * s = strstr(bit_width_str, formats[i]);
             if (s) {
                 usb_device_info->setBitWidth(bit_width[i]);
-                setEndian(strstr(s, "BE") ? 1 : 0);
+                entry.endian[type] = strstr(s, "BE") ? 1 : 0;
                 break;
             }
         }
@@ -639,18 +644,57 @@ int USBCardConfig::getCapability(usb_usecase_type_t type,
                 PAL_INFO(LOG_TAG, "error unable to get service interval, assume default");
             }
         }
-        /* jack status parsing */
-        suffix = (type == USB_PLAYBACK) ? USB_OUT_JACK_SUFFIX : USB_IN_JACK_SUFFIX;
-        jack_status = getJackConnectionStatus(addr.card_id, suffix);
-        PAL_DBG(LOG_TAG, "jack_status %d", jack_status);
-        usb_device_info->setJackStatus(jack_status);
-
         /* Add to list if every field is valid */
-        usb_device_config_list_.push_back(usb_device_info);
-        format_list_map.insert( std::pair<int, std::shared_ptr<USBDeviceConfig>>(usb_device_info->getBitWidth(),usb_device_info));
+        entry.profiles[type].push_back(usb_device_info);
     }
 
-     usb_info_dump(read_buf, type);
+
+    usb_info_dump(read_buf, type);
+
+    return ret;
+}
+
+/*
+ * Reads stream0 once and parses both directions, so that the Rx and Tx
+ * halves of a headset share a single pass over /proc.
+ */
+int USBCardConfig::loadCapability(struct pal_usb_device_address addr,
+                                  usb_capability_cache_entry &entry) {
+    FILE *fd = NULL;
+    char *read_buf = NULL;
+    char path[128];
+    int ret = 0;
+    size_t num_read = 0;
+
+    memset(path, 0, sizeof(path));
+    ret = snprintf(path, sizeof(path), "/proc/asound/card%u/stream0",
+             addr.card_id);
+    if(ret < 0) {
+        PAL_ERR(LOG_TAG, "failed on snprintf (%d) to path %s\n", ret, path);
+        ret = -EINVAL;
+        goto done;
+    }
+    ret = 0;
+
+    fd = fopen(path, "r");
+    if (!fd) {
+        PAL_ERR(LOG_TAG, "failed to open config file %s error: %d\n", path, errno);
+        ret = -EINVAL;
+        goto done;
+    }
+
+    read_buf = (char *)calloc(1, USB_BUFF_SIZE + 1);
+    if (!read_buf) {
+        PAL_ERR(LOG_TAG, "Failed to create read_buf");
+        ret = -ENOMEM;
+        goto done;
+    }
+
+    num_read = fread(read_buf, 1, USB_BUFF_SIZE, fd);
+    read_buf[num_read] = '\0';
+
+    entry.status[USB_PLAYBACK] = parseCapability(USB_PLAYBACK, read_buf, entry);
+    entry.status[USB_CAPTURE] = parseCapability(USB_CAPTURE, read_buf, entry);
 
 done:
     if (fd)
@@ -662,6 +706,89 @@ done:
     return ret;
 }
 
+int USBCardConfig::getCapability(usb_usecase_type_t type,
+                                        struct pal_usb_device_address addr) {
+    int ret = 0;
+    const char* suffix;
+    bool jack_status;
+    usb_capability_cache_entry entry;
+    std::string usbid = readUsbId(addr.card_id);
+    std::pair<int, int> key(addr.card_id, addr.device_num);
+
+    PAL_INFO(LOG_TAG, "for %s", (type == USB_PLAYBACK) ?
+          PLAYBACK_PROFILE_STR : CAPTURE_PROFILE_STR);
+
+    std::unique_lock<std::mutex> lock(capability_cache_mutex_);
+    auto it = capability_cache_.find(key);
+    if (it != capability_cache_.end() && (usbid.empty() || it->second.usbid != usbid)) {
+        PAL_INFO(LOG_TAG, "card %d now hosts usbid %s, dropping cached capability",
+                 addr.card_id, usbid.c_str());
+        capability_cache_.erase(it);
+        it = capability_cache_.end();
+    }
+
+    if (it != capability_cache_.end()) {
+        PAL_INFO(LOG_TAG, "using cached capability for usbid %s", usbid.c_str());
+        entry = it->second;
+    } else {
+        entry.usbid = usbid;
+        ret = loadCapability(addr, entry);
+        if (ret)
+            return ret;
+        if (!usbid.empty())
+            capability_cache_[key] = entry;
+    }
+    lock.unlock();
+
+    ret = entry.status[type];
+    if (ret == -ENOENT)
+        return ret;
+
+    setEndian(entry.endian[type]);
+
+    /* jack status parsing */
+    suffix = (type == USB_PLAYBACK) ? USB_OUT_JACK_SUFFIX : USB_IN_JACK_SUFFIX;
+    jack_status = getJackConnectionStatus(addr.card_id, suffix);
+    PAL_DBG(LOG_TAG, "jack_status %d", jack_status);
+
+    for (auto &usb_device_info : entry.profiles[type]) {
+        usb_device_info->setJackStatus(jack_status);
+        usb_device_config_list_.push_back(usb_device_info);
+        format_list_map.insert(std::pair<int, std::shared_ptr<USBDeviceConfig>>(
+                usb_device_info->getBitWidth(), usb_device_info));
+    }
+    buildProfileTable();
+
+    return ret;
+}
+
+void USBCardConfig::buildProfileTable()
+{
+    profile_table_.clear();
+    for (size_t i = 0; i < usb_device_config_list_.size(); i++) {
+        std::shared_ptr<USBDeviceConfig> profile = usb_device_config_list_[i];
+        for (unsigned int rate : profile->getRates()) {
+            usb_profile_entry entry = {profile->getType(), profile->getBitWidth(),
+                    profile->getChannels(), rate, profile->getInterval(), i};
+            profile_table_.push_back(entry);
+        }
+    }
+    std::stable_sort(profile_table_.begin(), profile_table_.end(), usbProfileLess);
+}
+
+bool USBCardConfig::findProfile(uint32_t type, uint32_t bit_width, uint32_t channels,
+                                std::vector<usb_profile_entry>::iterator *first,
+                                std::vector<usb_profile_entry>::iterator *last)
+{
+    usb_profile_entry key = {type, bit_width, channels, 0, 0, 0};
+    auto range = std::equal_range(profile_table_.begin(), profile_table_.end(),
+                                  key, usbProfileFormatLess);
+
+    *first = range.first;
+    *last = range.second;
+    return range.first != range.second;
+}
+
 USBCardConfig::USBCardConfig(struct pal_usb_device_address address) {
     address_ = address;
 }
@@ -860,11 +987,11 @@ int USBCardConfig::readBestConfig(struct pal_media_config *config,
     int max_channel = 0;
     int bitwidth = 16;
     int candidate_sr = 0;
-    int ret = -EINVAL;
+    int base = 0;
     struct pal_media_config media_config;
-    std::map<int, std::shared_ptr<USBDeviceConfig>> candidate_list;
-    std::vector<std::shared_ptr<USBDeviceConfig>> profile_list_max_ch;
-    std::vector<std::shared_ptr<USBDeviceConfig>> profile_list_match_ch;
+    uint32_t type = is_playback ? USB_PLAYBACK : USB_CAPTURE;
+    const uint32_t uhqa_rates[] = {SAMPLINGRATE_192K, SAMPLINGRATE_96K};
+    std::vector<usb_profile_entry>::iterator first, last, rate_iter;
     int target_bit_width = devinfo->bit_width == 0 ?
                            config->bit_width : devinfo->bit_width;
 
@@ -895,63 +1022,59 @@ int USBCardConfig::readBestConfig(struct pal_media_config *config,
         }
 
         max_channel = getMaxChannels(is_playback);
-        auto profile_list = format_list_map.equal_range(target_bit_width);
-        for (auto iter = profile_list.first; iter != profile_list.second; ++iter) {
-            auto cfg_iter = iter->second;
-            if (cfg_iter->getType() != is_playback)
-                continue;
-            if (cfg_iter->getChannels() == media_config.ch_info.channels) {
-                profile_list_match_ch.push_back(cfg_iter);
-            } else if(cfg_iter->getChannels() == max_channel) {
-                profile_list_max_ch.push_back(cfg_iter);
-            }
-        }
-
-        std::vector<std::shared_ptr<USBDeviceConfig>> profile_list_ch;
-        if (!profile_list_match_ch.empty()) {
+        if (findProfile(type, target_bit_width, media_config.ch_info.channels,
+                        &first, &last)) {
             /*2. channal matches */
-            profile_list_ch = profile_list_match_ch;
             PAL_INFO(LOG_TAG, "found matching channels = %d", media_config.ch_info.channels);
         } else {
-            profile_list_ch = profile_list_max_ch;
+            findProfile(type, target_bit_width, max_channel, &first, &last);
             PAL_INFO(LOG_TAG, "Target Channel of %d is not supported by USB. Use USB channel of %d",
                          media_config.ch_info.channels, max_channel);
         }
 
-        if (!profile_list_ch.empty()) {
+        if (first != last) {
             /*3. get best Sample Rate */
             if (uhqa && is_playback) {
-                for (auto ch_iter = profile_list_ch.begin(); ch_iter!= profile_list_ch.end(); ++ch_iter) {
-                    if ((*ch_iter)->isRateSupported(SAMPLINGRATE_192K)) {
-                        config->sample_rate = SAMPLINGRATE_192K;
-                        candidate_config = *ch_iter;
+                for (uint32_t uhqa_rate : uhqa_rates) {
+                    rate_iter = std::lower_bound(first, last, uhqa_rate, usbProfileRateLess);
+                    if (rate_iter != last && rate_iter->sample_rate == uhqa_rate) {
+                        config->sample_rate = uhqa_rate;
+                        candidate_config = usb_device_config_list_[rate_iter->profile_idx];
                         break;
-                    } else if ((*ch_iter)->isRateSupported(SAMPLINGRATE_96K)) {
-                        config->sample_rate = SAMPLINGRATE_96K;
-                        candidate_config = *ch_iter;
                     }
-               }
-               if (candidate_config) {
-                   PAL_INFO(LOG_TAG, "uhqa: found matching SampleRate = %d", config->sample_rate);
-                   goto UpdateBestCh;
-               }
+                }
+                if (candidate_config) {
+                    PAL_INFO(LOG_TAG, "uhqa: found matching SampleRate = %d", config->sample_rate);
+                    goto UpdateBestCh;
+                }
             }
 
-            for (auto ch_iter = profile_list_ch.begin(); ch_iter!= profile_list_ch.end(); ++ch_iter) {
-                int ret = (*ch_iter)->getBestRate(target_sample_rate, candidate_sr,
-                                        &config->sample_rate);
-                if (ret == 0) {
-                    PAL_INFO(LOG_TAG, "found matching SampleRate = %d", config->sample_rate);
-                    candidate_config = *ch_iter;
-                    break;
-                }
-                /* if target Sample Rate is not supported by USB, look for best one
-                   in all profile list that channel and bit-width match.*/
-                candidate_list.insert(std::pair<int, std::shared_ptr<USBDeviceConfig>>
-                                               (config->sample_rate, *ch_iter));
+            rate_iter = std::lower_bound(first, last, (uint32_t)target_sample_rate,
+                                         usbProfileRateLess);
+            if (rate_iter != last && rate_iter->sample_rate == target_sample_rate) {
+                config->sample_rate = target_sample_rate;
+                candidate_config = usb_device_config_list_[rate_iter->profile_idx];
+                PAL_INFO(LOG_TAG, "found matching SampleRate = %d", config->sample_rate);
+                goto UpdateBestCh;
+            }
+
+            /* if target Sample Rate is not supported by USB, look for best one
+               in all profile list that channel and bit-width match.*/
+            base = (target_sample_rate % SAMPLINGRATE_8K == 0) ?
+                    SAMPLINGRATE_8K : SAMPLINGRATE_22K;
+            for (rate_iter = first; rate_iter != last; ++rate_iter) {
+                if (candidate_sr == 0)
+                    candidate_sr = rate_iter->sample_rate;
+                usb_device_config_list_[rate_iter->profile_idx]->usb_find_sample_rate_candidate(
+                        base, target_sample_rate, rate_iter->sample_rate, candidate_sr,
+                        &config->sample_rate);
                 candidate_sr = config->sample_rate;
-                candidate_config = candidate_list[candidate_sr];
             }
+            rate_iter = std::lower_bound(first, last, (uint32_t)candidate_sr, usbProfileRateLess);
+            if (rate_iter != last)
+                candidate_config = usb_device_config_list_[rate_iter->profile_idx];
+            PAL_DBG(LOG_TAG, "requested_rate %d, best_rate %u", target_sample_rate,
+                    config->sample_rate);
 UpdateBestCh:
             if (candidate_config)
                 candidate_config->updateBestChInfo(&media_config.ch_info, &config->ch_info);
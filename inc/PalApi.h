@@ -368,6 +368,31 @@ int32_t pal_stream_get_device(pal_stream_handle_t *stream_handle,
 int32_t pal_stream_set_device(pal_stream_handle_t *stream_handle,
                            uint32_t no_of_devices, struct pal_device *devices);
 
+/**
+  * \brief Asynchronous variants of pal_stream_start, pal_stream_stop,
+  *        pal_stream_set_device and pal_stream_close.
+  *
+  * The operation is queued on the stream's ordered executor and the call
+  * returns immediately. Operations on one stream run in submission order;
+  * read/write and the synchronous control APIs on that stream wait for
+  * queued operations first. Completion is reported through the callback
+  * given to pal_stream_open with PAL_STREAM_CBK_EVENT_ASYNC_DONE and a
+  * pal_event_async_done_payload. The handle must not be used after
+  * pal_stream_close_async has been called.
+  *
+  * \param[in] stream_handle - Valid stream handle obtained
+  *       from pal_stream_open
+  * \param[in] no_of_devices, devices - as for pal_stream_set_device,
+  *       copied before the call returns
+  *
+  * \return 0 if the operation was queued, error code otherwise
+  */
+int32_t pal_stream_start_async(pal_stream_handle_t *stream_handle);
+int32_t pal_stream_stop_async(pal_stream_handle_t *stream_handle);
+int32_t pal_stream_set_device_async(pal_stream_handle_t *stream_handle,
+                           uint32_t no_of_devices, struct pal_device *devices);
+int32_t pal_stream_close_async(pal_stream_handle_t *stream_handle);
+
 /**
   * \brief Get audio parameters specific to a stream.
   *
@@ -398,6 +423,25 @@ int32_t pal_stream_get_param(pal_stream_handle_t *stream_handle,
 int32_t pal_stream_set_param(pal_stream_handle_t *stream_handle,
                            uint32_t param_id, pal_param_payload *param_payload);
 
+/**
+  * \brief Set several audio parameters of a stream in one call.
+  *        Params are applied in order; setParam payloads are combined
+  *        and sent to the DSP together where the session supports it.
+  *        Params ahead of a failing one remain applied.
+  *
+  * \param[in] stream_handle - Valid stream handle obtained
+  *       from pal_stream_open
+  * \param[in] no_of_params - number of entries in param_ids and
+  *       param_payloads
+  * \param[in] param_ids - param ids, as for pal_stream_set_param
+  * \param[in] param_payloads - param data for each param_id
+  *
+  * \return 0 on success, error code of the first failure otherwise
+  */
+int32_t pal_stream_set_params(pal_stream_handle_t *stream_handle,
+                           uint32_t no_of_params, uint32_t *param_ids,
+                           pal_param_payload **param_payloads);
+
 /**
   * \brief Get audio volume specific to a stream.
   *
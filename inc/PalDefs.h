@@ -729,6 +729,7 @@ typedef enum {
     PAL_STREAM_CBK_EVENT_PARTIAL_DRAIN_READY, /* partial drain completed */
     PAL_STREAM_CBK_EVENT_READ_DONE, /* stream hit some error, let AF take action */
     PAL_STREAM_CBK_EVENT_ERROR, /* stream hit some error, let AF take action */
+    PAL_STREAM_CBK_EVENT_ASYNC_DONE, /* pal_stream_*_async operation completed */
 } pal_stream_callback_event_t;
 
 /* type of global callback events. */
@@ -953,6 +954,16 @@ struct pal_session_time {
     struct pal_time_us timestamp;      /** Value of the last processed time stamp in microseconds */
 };
 
+/* Payload For ID: PAL_PARAM_ID_TIMESTAMP_INFO
+ * Description   : stream get only, pal_param_payload sized by the caller.
+ *                 Session time plus how much of it is extrapolated.
+*/
+typedef struct pal_timestamp_info {
+    struct pal_session_time stime;
+    uint64_t age_us;        /** age of the DSP reading behind stime, 0 if just queried */
+    uint32_t extrapolated;  /** 1 if stime was advanced from an older DSP reading */
+} pal_timestamp_info_t;
+
 /** EVENT configurations data strucutre defintion used as
  *  argument for mute command */
 //typedef union {
@@ -1048,6 +1059,10 @@ typedef enum {
     PAL_PARAM_ID_LATENCY_MODE = 73,
     PAL_PARAM_ID_PROXY_RECORD_SESSION = 74,
     PAL_PARAM_ID_ULTRASOUND_SET_GAIN = 75,
+    PAL_PARAM_ID_VOICE_PREARM = 76,
+    PAL_PARAM_ID_THREAD_POLICY = 77,
+    PAL_PARAM_ID_TIMESTAMP_INFO = 78,
+    PAL_PARAM_ID_POWER_VOTE_STATS = 79,
 } pal_param_id_type_t;
 
 /** HDMI/DP */
@@ -1289,6 +1304,42 @@ typedef struct pal_param_latency_mode {
     uint32_t        modes[PAL_MAX_LATENCY_MODES]; /* list of supported modes or use mode[0] for set latency mode */
 } pal_param_latency_mode_t;
 
+/* Payload For ID: PAL_PARAM_ID_VOICE_PREARM
+ * Description   : bool in pal_param_payload, for an opened voice call stream
+ *                 that is not started. true opens and configures the call graph
+ *                 so that pal_stream_start only starts it, false drops it.
+*/
+
+/* Payload For ID: PAL_PARAM_ID_THREAD_POLICY
+ * Description   : get only, array of pal_thread_policy_info_t, one per live
+ *                 PAL thread, allocated by PAL and freed by the caller.
+*/
+#define PAL_THREAD_NAME_LEN 16
+typedef struct pal_thread_policy_info {
+    int32_t tid;
+    char name[PAL_THREAD_NAME_LEN];
+    char thread_class[PAL_THREAD_NAME_LEN];
+    int32_t sched_policy;   /* SCHED_OTHER, SCHED_FIFO, ... */
+    int32_t rt_priority;
+    int32_t nice;
+    uint64_t cpu_mask;      /* bit n set if the thread may run on cpu n */
+} pal_thread_policy_info_t;
+
+/* Payload For ID: PAL_PARAM_ID_POWER_VOTE_STATS
+ * Description   : get only, array of pal_power_vote_stats_t, one per power
+ *                 vote (wakelock, ADSP sleep monitor LPI/NLPI), allocated
+ *                 by PAL and freed by the caller.
+*/
+#define PAL_POWER_VOTE_NAME_LEN 16
+typedef struct pal_power_vote_stats {
+    char name[PAL_POWER_VOTE_NAME_LEN];
+    int32_t count;          /* current vote count */
+    uint64_t votes;
+    uint64_t unvotes;
+    uint64_t applied;       /* vote/release syscalls issued */
+    uint64_t absorbed;      /* releases cancelled by a new vote within the hold time */
+} pal_power_vote_stats_t;
+
 typedef struct pal_param_upd_event_detection {
     bool     register_status;
 } pal_param_upd_event_detection_t;
@@ -1582,6 +1633,22 @@ struct pal_event_read_write_done_payload {
     struct pal_buffer buff; /**< buffer that was passed to pal_stream_read/pal_stream_write */
 };
 
+/** Operations that can be queued with the pal_stream_*_async APIs */
+typedef enum {
+    PAL_ASYNC_OP_START,
+    PAL_ASYNC_OP_STOP,
+    PAL_ASYNC_OP_SET_DEVICE,
+    PAL_ASYNC_OP_CLOSE,
+} pal_async_op_t;
+
+/**
+ * Event payload passed to client with PAL_STREAM_CBK_EVENT_ASYNC_DONE
+ */
+struct pal_event_async_done_payload {
+    uint32_t op;     /**< pal_async_op_t that completed */
+    int32_t status;  /**< return value of the equivalent synchronous API */
+};
+
 /** @brief Callback function prototype to be given for
  *         pal_open_stream.
  *
@@ -50,6 +50,8 @@
 #include <queue>
 #include <deque>
 #include <unordered_map>
+#include <atomic>
+#include <chrono>
 #include <vui_dmgr_audio_intf.h>
 #include <audio_feature_stats_intf.h>
 #include <amdb_api.h>
@@ -62,6 +64,11 @@
 #include "SoundTriggerPlatformInfo.h"
 #include "SignalHandler.h"
 #include "MemLogBuilder.h"
+#include "PalMutex.h"
+#include "PowerVote.h"
+#include "TimerScheduler.h"
+#include "OffloadWorkerPool.h"
+#include "ThreadPolicy.h"
 
 typedef enum {
     RX_HOSTLESS = 1,
@@ -85,6 +92,8 @@ typedef enum {
 #define AUDIO_PARAMETER_KEY_UPD_SET_CUSTOM_GAIN "upd_set_custom_gain"
 #define AUDIO_PARAMETER_KEY_DUAL_MONO "dual_mono"
 #define AUDIO_PARAMETER_KEY_SIGNAL_HANDLER "signal_handler"
+#define AUDIO_PARAMETER_KEY_WARM_STREAM_POOL "warm_stream_pool_size"
+#define AUDIO_PARAMETER_KEY_WARM_STREAM_IDLE "warm_stream_idle_ms"
 #define AUDIO_PARAMETER_KEY_DEVICE_MUX "device_mux_config"
 #define AUDIO_PARAMETER_KEY_UPD_DUTY_CYCLE "upd_duty_cycle_enable"
 #define AUDIO_PARAMETER_KEY_UPD_VIRTUAL_PORT "upd_virtual_port"
@@ -310,6 +319,13 @@ struct pal_device_info {
      bool is32BitSupported;
 };
 
+/* pal_device_info of one device and stream type, resolved from the RM xml */
+struct device_info_entry {
+    struct pal_device_info info;
+    /* usecase custom config key -> info with that config applied */
+    std::vector<std::pair<std::string, struct pal_device_info>> customInfo;
+};
+
 struct vsid_modepair {
     unsigned int key;
     unsigned int value;
@@ -397,6 +413,16 @@ enum NTStreamTypes_t : uint32_t {
 
 typedef void (*session_callback)(uint64_t hdl, uint32_t event_id, void *event_data,
                 uint32_t event_size);
+
+/* "PCM<id> event"/"COMPRESS<id> event" control of a registered session */
+struct mixer_event_slot {
+    int pcmId;
+    struct mixer_ctl *ctl;
+    unsigned int numValues;
+    session_callback cb;
+    uint64_t cookie;
+};
+
 bool isPalPCMFormat(uint32_t fmt_id);
 
 typedef void* (*adm_init_t)();
@@ -436,6 +462,24 @@ class StreamContextProxy;
 class StreamCommonProxy;
 class StreamHaptics;
 
+/* pcm stream muted for an a2dp transition, waited on until its stale data played out */
+struct muted_drain_entry {
+    Stream *s;
+    uint32_t latencyMs;
+    uint64_t startUs;   /* session time at mute */
+    uint64_t lastUs;    /* session time last seen advancing */
+    bool tracked;       /* false when the session time could not be read */
+    std::chrono::steady_clock::time_point muteTime;
+    /* remaining latency plus A2DP_DRAIN_SLACK_MS, from mute or last progress */
+    std::chrono::steady_clock::time_point deadline;
+};
+
+/* Tx stream that takes an EC reference on one of its active Tx devices */
+struct ec_ref_tx_node {
+    std::shared_ptr<Device> txDev;
+    pal_stream_type_t type;
+};
+
 struct deviceIn {
     int deviceId;
     int max_channel;
@@ -444,18 +488,6 @@ struct deviceIn {
     std::vector<usecase_info> usecase;
     // dev ids supporting ec ref
     std::vector<pal_device_id_t> rx_dev_ids;
-    /*
-     * map dynamically maintain ec ref count, key for this map
-     * is rx device id, which is present in rx_dev_ids, and value
-     * for this map is a vector of all active tx streams using
-     * this rx device as ec ref. For each Tx stream, we have a
-     * EC ref count, indicating number of Rx streams which uses
-     * this rx device as output device and also not disabled stream
-     * type to the Tx stream. E.g., for SVA and Recording stream,
-     * LL playback with speaker may only count for Recording stream
-     * when ll barge-in is not enabled.
-     */
-    std::map<int, std::vector<std::pair<Stream *, int>>> ec_ref_count_map;
     std::string sndDevName;
     bool isExternalECRefEnabled;
     bool isUSBUUIdBasedTuningEnabled;
@@ -493,6 +525,8 @@ private:
     int32_t streamDevConnect(std::vector <std::tuple<Stream *, struct pal_device *>> streamDevConnectList);
     int32_t streamDevDisconnect_l(std::vector <std::tuple<Stream *, uint32_t>> streamDevDisconnectList);
     int32_t streamDevConnect_l(std::vector <std::tuple<Stream *, struct pal_device *>> streamDevConnectList);
+    int32_t streamDevSwitchMbb_l(std::vector <std::tuple<Stream *, uint32_t>> &streamDevDisconnectList,
+                                 std::vector <std::tuple<Stream *, struct pal_device *>> &streamDevConnectList);
     void ssrHandlingLoop(std::shared_ptr<ResourceManager> rm);
     int updateECDeviceMap(std::shared_ptr<Device> rx_dev,
                         std::shared_ptr<Device> tx_dev,
@@ -510,6 +544,9 @@ private:
     void onVUIStreamRegistered();
     void onVUIStreamDeregistered();
     int setUltrasoundGain(pal_ultrasound_gain_t gain, Stream *s);
+    static void onUltrasoundGainTimeout(void *cookie);
+    static void onLpiRestoreTimeout(void *cookie);
+    static void runLpiRestore(void *cookie, int cmd);
     bool checkDeviceSwitchForHaptics(struct pal_device *inDevAttr, struct pal_device *curDevAttr);
 protected:
     std::list <Stream*> mActiveStreams;
@@ -547,11 +584,31 @@ protected:
     bool is_ICL_config_;
     pal_speaker_rotation_type rotation_type_;
     bool isDeviceSwitch = false;
-    static std::mutex mResourceManagerMutex;
-    static std::mutex mGraphMutex;
-    static std::mutex mActiveStreamMutex;
-    static std::mutex mSleepMonitorMutex;
-    static std::mutex mListFrontEndsMutex;
+    /*
+     * Global RM locks, taken in the order mActiveStreamMutex, then a stream's
+     * own mutex, then mResourceManagerMutex. They are not split per device:
+     * device switch, EC and concurrency paths update the stream lists, the
+     * device registrations and the EC graph as one step under them. Only the
+     * EC graph has a leaf lock of its own. PAL_LOCK_ORDER_CHECK builds
+     * report inversions between them.
+     */
+    static PalMutex mResourceManagerMutex;
+    static PalMutex mGraphMutex;
+    static PalMutex mActiveStreamMutex;
+    static PalMutex mListFrontEndsMutex;
+    /* guards ecRefEdges and ecRefTxNodes, never held across other locks */
+    static PalMutex mECRefMutex;
+    /*
+     * EC reference graph, both keyed by a Tx stream and one of its Tx
+     * devices. ecRefEdges maps each to the Rx devices used as its echo
+     * reference, each with the number of Rx streams on that device counted
+     * for the Tx stream type (e.g. LL playback on speaker only counts for
+     * recording, not for SVA, when ll barge-in is disabled). ecRefTxNodes
+     * holds the pairs with EC enabled, so an Rx stream change visits only
+     * those instead of every active stream and device.
+     */
+    std::map<std::pair<Stream *, int>, std::map<int, int>> ecRefEdges;
+    std::map<std::pair<Stream *, int>, struct ec_ref_tx_node> ecRefTxNodes;
     static int snd_virt_card;
     static int snd_hw_card;
 
@@ -592,6 +649,14 @@ protected:
     static std::map<int, std::string> spkrTempCtrlsMap;
     static std::map<uint32_t, uint32_t> btSlimClockSrcMap;
     static std::vector<deviceIn> deviceInfo;
+    /* device id -> row of deviceInfoTable, -1 if not in deviceInfo */
+    static std::vector<int32_t> deviceInfoIndex;
+    /* row * PAL_STREAM_MAX + stream type, built once the RM xml is parsed */
+    static std::vector<struct device_info_entry> deviceInfoTable;
+    /* key NULL: no usecase custom config is applied */
+    void resolveDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t type,
+                           const std::string *key, struct pal_device_info *devinfo);
+    void buildDeviceInfoTable();
     static std::vector<tx_ecinfo> txEcInfo;
     static struct vsid_info vsidInfo;
     static struct volume_set_param_info volumeSetParamInfo_;
@@ -617,18 +682,25 @@ protected:
     static defer_switch_state_t deferredSwitchState;
     static int wake_lock_fd;
     static int wake_unlock_fd;
-    static uint32_t wake_lock_cnt;
+    static PowerVote *wakeLockVote;
     static bool lpi_logging_;
     std::map<int, std::pair<session_callback, uint64_t>> mixerEventCallbackMap;
+    /* registered event controls keyed by ALSA ctl numid, see dispatchMixerEvent */
+    std::unordered_map<unsigned int, struct mixer_event_slot> mixerEventSlots;
+    static PalMutex mMixerEventMutex;
     static std::thread mixerEventTread;
     std::shared_ptr<CaptureProfile> SoundTriggerCaptureProfile;
     ResourceManager();
     ContextManager *ctxMgr;
 #ifdef ADSP_SLEEP_MONITOR
-    int32_t lpi_counter_;
-    int32_t nlpi_counter_;
+    PowerVote *lpiVote_;
+    PowerVote *nlpiVote_;
     int sleepmon_fd_;
+    static int applySleepMonitorLpi(void *cookie, bool on);
+    static int applySleepMonitorNlpi(void *cookie, bool on);
 #endif
+    static int applyWakeLock(void *cookie, bool on);
+    static uint32_t getPowerVoteHoldMs();
     static std::map<group_dev_config_idx_t, std::shared_ptr<group_dev_config_t>> groupDevConfigMap;
     std::array<std::shared_ptr<nonTunnelInstMap_t>, DEFAULT_NT_SESSION_TYPE_COUNT> mNTStreamInstancesList;
     int32_t scoOutConnectCount = 0;
@@ -662,6 +734,15 @@ public:
     static bool isDummyDevEnabled;
     static bool isProxyRecordActive;
     static std::mutex mChargerBoostMutex;
+    /* deferred half of handlePBChargerInsertion, cancelled by a newer charger event */
+    static std::atomic<uint64_t> chargerInsertionTimer;
+    /* follow-up gain selection after UPD is muted, guarded by mResourceManagerMutex */
+    uint64_t updGainTimer = 0;
+    /* held back NLPI->LPI switch of detection streams, guarded by mActiveStreamMutex */
+    uint64_t lpiRestoreTimer = 0;
+    bool lpiRestorePending = false;
+    /* runs the held back switch off the shared timer thread */
+    struct offload_task lpiRestoreTask;
     /* Variable to store which speaker side is being used for call audio.
      * Valid for Stereo case only
      */
@@ -754,7 +835,7 @@ public:
                             struct pal_stream_attributes *attributes);
     /*getDeviceInfo - updates channels, fluence info of the device*/
     void getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t type,
-                       std::string key, struct pal_device_info *devinfo);
+                       const std::string &key, struct pal_device_info *devinfo);
     bool getEcRefStatus(pal_stream_type_t tx_streamtype,pal_stream_type_t rx_streamtype);
     int32_t getVsidInfo(struct vsid_info  *info);
     int32_t getVolumeSetParamInfo(struct volume_set_param_info *volinfo);
@@ -915,6 +996,8 @@ public:
     static void mixerEventWaitThreadLoop(std::shared_ptr<ResourceManager> rm);
     bool isCallbackRegistered() { return (mixerEventRegisterCount > 0); }
     int handleMixerEvent(struct mixer *mixer, char *mixer_str);
+    void updateMixerEventSlot(int pcmId, session_callback cb, uint64_t cookie, bool add);
+    int dispatchMixerEvent(unsigned int numid, const char *name, std::vector<char> &buf);
     int StopOtherDetectionStreams(void *st);
     int StartOtherDetectionStreams(void *st);
     void GetConcurrencyInfo(pal_stream_type_t st_type,
@@ -935,6 +1018,8 @@ public:
         Stream *rx_str, std::shared_ptr<Device> rx_device);
     std::vector<Stream*> getConcurrentTxStream_l(
         Stream *rx_str, std::shared_ptr<Device> rx_device);
+    std::vector<std::pair<Stream *, std::shared_ptr<Device>>> getConcurrentECRefTx_l(
+        Stream *rx_str, std::shared_ptr<Device> rx_device);
     bool checkECRef(std::shared_ptr<Device> rx_dev,
                     std::shared_ptr<Device> tx_dev);
     bool isExternalECSupported(std::shared_ptr<Device> tx_dev);
@@ -979,6 +1064,7 @@ public:
     static int setUpdCustomGainParam(struct str_parms *parms,char *value, int len);
     static int setDualMonoEnableParam(struct str_parms *parms,char *value, int len);
     static int setSignalHandlerEnableParam(struct str_parms *parms,char *value, int len);
+    static int setWarmStreamPoolParam(struct str_parms *parms,char *value, int len);
     static int setMuxconfigEnableParam(struct str_parms *parms,char *value, int len);
     static int setHapticsPriorityParam(struct str_parms *parms,char *value, int len);
     static int setHapticsDrivenParam(struct str_parms *parms,char *value, int len);
@@ -1016,6 +1102,8 @@ public:
     int32_t a2dpCaptureResume(pal_device_id_t dev_id);
     int32_t a2dpCaptureResumeFromDummy(pal_device_id_t dev_id);
     int32_t a2dpReconfig();
+    void addMutedDrain_l(Stream *s, std::vector<struct muted_drain_entry> &pending);
+    void waitMutedDrain(std::vector<struct muted_drain_entry> &pending);
     bool isPluginDevice(pal_device_id_t id);
     bool isDpDevice(pal_device_id_t id);
     bool isPluginPlaybackDevice(pal_device_id_t id);
@@ -1065,6 +1153,7 @@ public:
                                                  bool concurrent_state);
     int chargerListenerSetBoostState(bool state, charger_boost_mode_t mode);
     int handlePBChargerInsertion(Stream *stream);
+    static void onChargerInsertionTimeout(void *cookie);
     int handlePBChargerRemoval(Stream *stream);
     static bool isGroupConfigAvailable(group_dev_config_idx_t idx);
     int checkAndUpdateGroupDevConfig(struct pal_device *deviceattr,
@@ -45,6 +45,7 @@
 #include <sys/ioctl.h>
 #include "ResourceManager.h"
 #include "Session.h"
+#include "TimestampCache.h"
 #include "Device.h"
 #include "Stream.h"
 #include "StreamPCM.h"
@@ -58,6 +59,7 @@
 #include "StreamSensorPCMData.h"
 #include "StreamCommonProxy.h"
 #include "StreamHaptics.h"
+#include "WarmStreamPool.h"
 #include "gsl_intf.h"
 #include "Headphone.h"
 #include "PayloadBuilder.h"
@@ -158,6 +160,19 @@
 #define CLOCK_SRC_DEFAULT 1
 
 #define WAIT_LL_PB 4
+/* lets the DSP run 3 to 4 process calls on a UPD mute before the next gain */
+#define UPD_GAIN_SETTLE_MS 20
+/* concurrency that ends and restarts within this window keeps detection in NLPI */
+#define ST_LPI_RESTORE_HOLD_MS 300
+/* margin over the measured remaining latency of a muted stream before giving up on it */
+#define A2DP_DRAIN_SLACK_MS 20
+/* each poll queries the DSP, no faster than the timestamp cache would */
+#define A2DP_DRAIN_POLL_MS (PAL_TIMESTAMP_QUERY_INTERVAL_US / 1000)
+/* a2dp reconfig fails if the BT stack is not ready by then */
+#define A2DP_RECONFIG_READY_TIMEOUT_MS 2000
+/* the switch back can still fail right after the stack reports ready */
+#define A2DP_RECONFIG_RETRY_COUNT 20
+#define A2DP_RECONFIG_RETRY_PERIOD_MS 100
 #define WAIT_RECOVER_FET 150000
 
 /*this can be over written by the config file settings*/
@@ -456,12 +471,14 @@ std::vector <int> ResourceManager::streamPpTag = {0};
 std::vector <int> ResourceManager::mixerTag = {0};
 std::vector <int> ResourceManager::devicePpTag = {0};
 std::vector <int> ResourceManager::deviceTag = {0};
-std::mutex ResourceManager::mResourceManagerMutex;
+PalMutex ResourceManager::mResourceManagerMutex("rm");
 std::mutex ResourceManager::mChargerBoostMutex;
-std::mutex ResourceManager::mGraphMutex;
-std::mutex ResourceManager::mActiveStreamMutex;
-std::mutex ResourceManager::mSleepMonitorMutex;
-std::mutex ResourceManager::mListFrontEndsMutex;
+std::atomic<uint64_t> ResourceManager::chargerInsertionTimer(0);
+PalMutex ResourceManager::mGraphMutex("rm-graph");
+PalMutex ResourceManager::mActiveStreamMutex("rm-active-stream");
+PalMutex ResourceManager::mListFrontEndsMutex("rm-list-frontends");
+PalMutex ResourceManager::mECRefMutex("rm-ec-ref");
+PalMutex ResourceManager::mMixerEventMutex("rm-mixer-event");
 std::vector <int> ResourceManager::listAllFrontEndIds = {0};
 std::vector <int> ResourceManager::listFreeFrontEndIds = {0};
 std::vector <int> ResourceManager::listAllPcmPlaybackFrontEnds = {0};
@@ -518,7 +535,7 @@ int ResourceManager::SNSPCMDataConcurrencyDisableCount = 0;
 defer_switch_state_t ResourceManager::deferredSwitchState = NO_DEFER;
 int ResourceManager::wake_lock_fd = -1;
 int ResourceManager::wake_unlock_fd = -1;
-uint32_t ResourceManager::wake_lock_cnt = 0;
+PowerVote* ResourceManager::wakeLockVote = nullptr;
 static int max_session_num;
 bool ResourceManager::isSpeakerProtectionEnabled = false;
 bool ResourceManager::isHandsetProtectionEnabled = false;
@@ -575,6 +592,8 @@ void str_parms_destroy(struct str_parms *str_parms){return;}
 
 std::vector<vote_type_t> ResourceManager::sleep_monitor_vote_type_(PAL_STREAM_MAX, NLPI_VOTE);
 std::vector<deviceIn> ResourceManager::deviceInfo;
+std::vector<int32_t> ResourceManager::deviceInfoIndex;
+std::vector<struct device_info_entry> ResourceManager::deviceInfoTable;
 std::vector<tx_ecinfo> ResourceManager::txEcInfo;
 std::vector <uint32_t> sndCardStandbySupportedStreams_;
 struct vsid_info ResourceManager::vsidInfo;
@@ -890,6 +909,7 @@ ResourceManager::ResourceManager()
         PAL_ERR(LOG_TAG, "error in resource xml parsing ret %d", ret);
         throw std::runtime_error("error in resource xml parsing");
     }
+    buildDeviceInfoTable();
 
     if (IsVirtualPortForUPDEnabled()) {
         updateVirtualBackendName();
@@ -918,12 +938,14 @@ ResourceManager::ResourceManager()
     }
 #endif
 #if defined(ADSP_SLEEP_MONITOR)
-    lpi_counter_ = 0;
-    nlpi_counter_ = 0;
     sleepmon_fd_ = -1;
     sleepmon_fd_ = open(ADSPSLEEPMON_DEVICE_NAME, O_RDWR);
     if (sleepmon_fd_ == -1)
         PAL_ERR(LOG_TAG, "Failed to open ADSP sleep monitor file");
+    lpiVote_ = new PowerVote("sleepmon-lpi", applySleepMonitorLpi, this,
+                             getPowerVoteHoldMs());
+    nlpiVote_ = new PowerVote("sleepmon-nlpi", applySleepMonitorNlpi, this,
+                              getPowerVoteHoldMs());
 #endif
     listAllFrontEndIds.clear();
     listFreeFrontEndIds.clear();
@@ -1092,6 +1114,8 @@ ResourceManager::~ResourceManager()
     usb_vendor_uuid_list.clear();
     devInfo.clear();
     deviceInfo.clear();
+    deviceInfoIndex.clear();
+    deviceInfoTable.clear();
     txEcInfo.clear();
 
     STInstancesLists.clear();
@@ -1112,6 +1136,9 @@ ResourceManager::~ResourceManager()
         delete ctxMgr;
     }
 #ifdef ADSP_SLEEP_MONITOR
+    /* drops votes still held for hysteresis */
+    delete lpiVote_;
+    delete nlpiVote_;
     if (sleepmon_fd_ >= 0)
         close(sleepmon_fd_);
 #endif
@@ -1177,6 +1204,8 @@ int ResourceManager::deregPeripheralCb(void *tz_handle)
 
 void ResourceManager::loadSocPeripheralLib()
 {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_BACKGROUND, "pal_soc_periph");
+
     if (access(SOC_PERIPHERAL_LIBRARY_PATH, R_OK) == 0) {
         socPeripheralLibHdl = dlopen(SOC_PERIPHERAL_LIBRARY_PATH, RTLD_NOW);
         if (socPeripheralLibHdl == NULL) {
@@ -1284,10 +1313,14 @@ int ResourceManager::initWakeLocks(void) {
             }
         }
     }
+    wakeLockVote = new PowerVote("wakelock", applyWakeLock, nullptr, getPowerVoteHoldMs());
     return 0;
 }
 
 void ResourceManager::deInitWakeLocks(void) {
+    /* releases a wakelock still held for hysteresis */
+    delete wakeLockVote;
+    wakeLockVote = nullptr;
     if (wake_lock_fd >= 0) {
         ::close(wake_lock_fd);
         wake_lock_fd = -1;
@@ -1298,48 +1331,50 @@ void ResourceManager::deInitWakeLocks(void) {
     }
 }
 
-void ResourceManager::acquireWakeLock() {
+uint32_t ResourceManager::getPowerVoteHoldMs()
+{
+    uint32_t holdMs = PAL_POWER_VOTE_HOLD_MS;
+#ifndef PAL_CUTILS_UNSUPPORTED
+    char value[PROPERTY_VALUE_MAX] = {0};
+
+    if (property_get("vendor.audio.power_vote_hold_ms", value, "") > 0)
+        holdMs = (uint32_t)atoi(value);
+#endif
+    return holdMs;
+}
+
+int ResourceManager::applyWakeLock(void *cookie __unused, bool on)
+{
+    int fd = on ? wake_lock_fd : wake_unlock_fd;
     int ret = 0;
 
-    mResourceManagerMutex.lock();
-    if (wake_lock_fd < 0) {
-        PAL_ERR(LOG_TAG, "Invalid fd %d", wake_lock_fd);
-        goto exit;
+    PAL_INFO(LOG_TAG, "%s wake lock %s", on ? "Acquiring" : "Releasing", WAKE_LOCK_NAME);
+    ret = ::write(fd, WAKE_LOCK_NAME, strlen(WAKE_LOCK_NAME));
+    if (ret < 0) {
+        PAL_ERR(LOG_TAG, "Failed to %s wakelock %d %s", on ? "acquire" : "release",
+            ret, strerror(errno));
+        return -errno;
     }
 
-    PAL_DBG(LOG_TAG, "wake lock count: %d", wake_lock_cnt);
-    if (++wake_lock_cnt == 1) {
-        PAL_INFO(LOG_TAG, "Acquiring wake lock %s", WAKE_LOCK_NAME);
-        ret = ::write(wake_lock_fd, WAKE_LOCK_NAME, strlen(WAKE_LOCK_NAME));
-        if (ret < 0)
-            PAL_ERR(LOG_TAG, "Failed to acquire wakelock %d %s",
-                ret, strerror(errno));
+    return 0;
+}
+
+void ResourceManager::acquireWakeLock() {
+    if (!wakeLockVote || wake_lock_fd < 0) {
+        PAL_ERR(LOG_TAG, "Invalid fd %d", wake_lock_fd);
+        return;
     }
 
-exit:
-    mResourceManagerMutex.unlock();
+    wakeLockVote->vote();
 }
 
 void ResourceManager::releaseWakeLock() {
-    int ret = 0;
-
-    mResourceManagerMutex.lock();
-    if (wake_unlock_fd < 0) {
+    if (!wakeLockVote || wake_unlock_fd < 0) {
         PAL_ERR(LOG_TAG, "Invalid fd %d", wake_unlock_fd);
-        goto exit;
-    }
-
-    PAL_DBG(LOG_TAG, "wake lock count: %d", wake_lock_cnt);
-    if (wake_lock_cnt > 0 && --wake_lock_cnt == 0) {
-        PAL_INFO(LOG_TAG, "Releasing wake lock %s", WAKE_LOCK_NAME);
-        ret = ::write(wake_unlock_fd, WAKE_LOCK_NAME, strlen(WAKE_LOCK_NAME));
-        if (ret < 0)
-            PAL_ERR(LOG_TAG, "Failed to release wakelock %d %s",
-                ret, strerror(errno));
+        return;
     }
 
-exit:
-     mResourceManagerMutex.unlock();
+    wakeLockVote->unvote();
 }
 
 bool ResourceManager::isSsrDownFeasible(std::shared_ptr<ResourceManager> rm,
@@ -1363,6 +1398,8 @@ bool ResourceManager::isSsrDownFeasible(std::shared_ptr<ResourceManager> rm,
 
 void ResourceManager::ssrHandlingLoop(std::shared_ptr<ResourceManager> rm)
 {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_BACKGROUND, "pal_ssr");
+
     card_status_t state;
     card_status_t prevState = CARD_STATUS_ONLINE;
     std::unique_lock<std::mutex> lock(rm->cvMutex);
@@ -1503,6 +1540,8 @@ int ResourceManager::initSndMonitor()
 void ResourceManager::ssrHandler(card_status_t state)
 {
     PAL_DBG(LOG_TAG, "Enter. state %d", state);
+    if (PAL_CARD_STATUS_DOWN(state))
+        WarmStreamPool::invalidate();
     cvMutex.lock();
     msgQ.push(state);
     cvMutex.unlock();
@@ -2067,14 +2106,12 @@ int32_t ResourceManager::voteSleepMonitor(Stream *str, bool vote, bool force_nlp
     int fd = 0;
     pal_stream_type_t type;
     bool lpi_stream = false;
-    struct adspsleepmon_ioctl_audio monitor_payload;
 
     if (sleepmon_fd_ == -1) {
         PAL_ERR(LOG_TAG, "ioctl device is not open");
         return -EINVAL;
     }
 
-    monitor_payload.version = ADSPSLEEPMON_IOCTL_AUDIO_VER_1;
     ret = str->getStreamType(&type);
     if (ret != 0) {
         PAL_ERR(LOG_TAG, "getStreamType failed with status : %d", ret);
@@ -2092,59 +2129,44 @@ int32_t ResourceManager::voteSleepMonitor(Stream *str, bool vote, bool force_nlp
                       !IsTransitToNonLPIOnChargingSupported());
     }
 
-    mSleepMonitorMutex.lock();
-    if (vote) {
-        if (lpi_stream) {
-            if (++lpi_counter_ >= 1) {
-                monitor_payload.command = ADSPSLEEPMON_AUDIO_ACTIVITY_LPI_START;
-                mSleepMonitorMutex.unlock();
-                ret = ioctl(sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
-                mSleepMonitorMutex.lock();
-            }
-        } else {
-            if (++nlpi_counter_ == 1) {
-                monitor_payload.command = ADSPSLEEPMON_AUDIO_ACTIVITY_START;
-                mSleepMonitorMutex.unlock();
-                ret = ioctl(sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
-                mSleepMonitorMutex.lock();
-            }
-        }
-    } else {
-        if (lpi_stream) {
-            if (--lpi_counter_ >= 0) {
-                monitor_payload.command = ADSPSLEEPMON_AUDIO_ACTIVITY_LPI_STOP;
-                mSleepMonitorMutex.unlock();
-                ret = ioctl(sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
-                mSleepMonitorMutex.lock();
-            } else if (lpi_counter_ < 0) {
-                PAL_ERR(LOG_TAG,
-                  "LPI vote count is negative, number of unvotes is more than number of votes");
-                lpi_counter_ = 0;
-            }
-        } else {
-            if (--nlpi_counter_ == 0) {
-                monitor_payload.command = ADSPSLEEPMON_AUDIO_ACTIVITY_STOP;
-                mSleepMonitorMutex.unlock();
-                ret = ioctl(sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
-                mSleepMonitorMutex.lock();
-            } else if(nlpi_counter_ < 0) {
-                PAL_ERR(LOG_TAG,
-                 "NLPI vote count is negative, number of unvotes is more than number of votes");
-                nlpi_counter_ = 0;
-            }
-        }
-    }
+    if (vote)
+        ret = lpi_stream ? lpiVote_->vote() : nlpiVote_->vote();
+    else
+        ret = lpi_stream ? lpiVote_->unvote() : nlpiVote_->unvote();
+
     if (ret) {
         PAL_ERR(LOG_TAG, "Failed to %s for %s use case", vote ? "vote" : "unvote",
                          lpi_stream ? "lpi" : "nlpi");
     } else {
         PAL_INFO(LOG_TAG, "%s done for %s use case, lpi votes %d, nlpi votes : %d",
-        vote ? "Voting" : "Unvoting", lpi_stream ? "lpi" : "nlpi", lpi_counter_, nlpi_counter_);
+        vote ? "Voting" : "Unvoting", lpi_stream ? "lpi" : "nlpi", lpiVote_->getCount(),
+        nlpiVote_->getCount());
     }
 
-    mSleepMonitorMutex.unlock();
     return ret;
 }
+
+int ResourceManager::applySleepMonitorLpi(void *cookie, bool on)
+{
+    ResourceManager *rm = (ResourceManager *)cookie;
+    struct adspsleepmon_ioctl_audio monitor_payload;
+
+    monitor_payload.version = ADSPSLEEPMON_IOCTL_AUDIO_VER_1;
+    monitor_payload.command = on ? ADSPSLEEPMON_AUDIO_ACTIVITY_LPI_START :
+                                   ADSPSLEEPMON_AUDIO_ACTIVITY_LPI_STOP;
+    return ioctl(rm->sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
+}
+
+int ResourceManager::applySleepMonitorNlpi(void *cookie, bool on)
+{
+    ResourceManager *rm = (ResourceManager *)cookie;
+    struct adspsleepmon_ioctl_audio monitor_payload;
+
+    monitor_payload.version = ADSPSLEEPMON_IOCTL_AUDIO_VER_1;
+    monitor_payload.command = on ? ADSPSLEEPMON_AUDIO_ACTIVITY_START :
+                                   ADSPSLEEPMON_AUDIO_ACTIVITY_STOP;
+    return ioctl(rm->sleepmon_fd_, ADSPSLEEPMON_IOCTL_AUDIO_ACTIVITY, &monitor_payload);
+}
 #else
 int32_t ResourceManager::voteSleepMonitor(Stream *str, bool vote, bool force_nlpi_vote)
 {
@@ -2164,8 +2186,7 @@ int32_t ResourceManager::voteSleepMonitor(Stream *str, bool vote, bool force_nlp
 int ResourceManager::handlePBChargerInsertion(Stream *stream)
 {
     int status = 0;
-    struct pal_device newDevAttr;
-    std::shared_ptr<Device> dev = nullptr;
+    uint64_t timer = 0;
 
     PAL_DBG(LOG_TAG, "Enter. charger status %d", is_charger_online_);
 
@@ -2185,20 +2206,48 @@ int ResourceManager::handlePBChargerInsertion(Stream *stream)
     //TODO handle below varaiable when dispatcher thread comes into picture.
     if (is_charger_online_)
         is_charger_online_ = false;
-
-    //Unlock HAL thread to setparam for enabling insertion notif. Playback.
     mChargerBoostMutex.unlock();
 
-    // Wait for 4s to honour low latency playback.
-    sleep(WAIT_LL_PB);
+    /*
+     * Wait for 4s to honour low latency playback. The rest runs from the
+     * timer thread so the caller is not parked, and a newer charger event
+     * cancels it (see PAL_PARAM_ID_CHARGER_STATE).
+     */
+    timer = TimerScheduler::getInstance()->schedule(WAIT_LL_PB * 1000,
+                                                    onChargerInsertionTimeout, this);
+    if (!timer) {
+        status = -ENOMEM;
+        goto exit;
+    }
+    TimerScheduler::getInstance()->cancel(chargerInsertionTimer.exchange(timer));
+
+exit:
+    PAL_DBG(LOG_TAG, "Exit status: %d", status);
+    return status;
+}
+
+void ResourceManager::onChargerInsertionTimeout(void *cookie)
+{
+    ResourceManager *rm = (ResourceManager *)cookie;
+    int status = 0;
+    struct pal_device newDevAttr;
+    std::shared_ptr<Device> dev = nullptr;
+
+    PAL_DBG(LOG_TAG, "Enter.");
 
     mChargerBoostMutex.lock();
     //Retain charger_online status to true after notif. PB
-    if (!is_charger_online_)
-        is_charger_online_ = true;
+    if (!rm->is_charger_online_)
+        rm->is_charger_online_ = true;
+
+    /* playback may have moved off speaker while waiting */
+    if (!rm->isDeviceActive(PAL_DEVICE_OUT_SPEAKER)) {
+        PAL_DBG(LOG_TAG, "speaker no longer active, skip device switch");
+        goto unlockChargerBoostMutex;
+    }
 
     newDevAttr.id = PAL_DEVICE_OUT_SPEAKER;
-    dev = Device::getInstance(&newDevAttr, rm);
+    dev = Device::getInstance(&newDevAttr, ResourceManager::getInstance());
 
     if (!dev)
         goto unlockChargerBoostMutex;
@@ -2209,15 +2258,13 @@ int ResourceManager::handlePBChargerInsertion(Stream *stream)
         goto unlockChargerBoostMutex;
     }
 
-    status = forceDeviceSwitch(dev, &newDevAttr);
+    status = rm->forceDeviceSwitch(dev, &newDevAttr);
     if (0 != status)
         PAL_ERR(LOG_TAG, "Failed to do Force Device switch %d", status);
 
 unlockChargerBoostMutex:
     mChargerBoostMutex.unlock();
-exit:
     PAL_DBG(LOG_TAG, "Exit status: %d", status);
-    return status;
 }
 
 /*
@@ -2495,9 +2542,9 @@ bool ResourceManager::getEcRefStatus(pal_stream_type_t tx_streamtype,pal_stream_
     return ecref_status;
 }
 
-void ResourceManager::getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t type, std::string key, struct pal_device_info *devinfo)
+void ResourceManager::resolveDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t type,
+                                        const std::string *key, struct pal_device_info *devinfo)
 {
-    bool found = false;
 
     for (int32_t i = 0; i < deviceInfo.size(); i++) {
         if (deviceId == deviceInfo[i].deviceId) {
@@ -2516,7 +2563,8 @@ void ResourceManager::getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t
             devinfo->bit_width_overwrite = false;
             devinfo->fractionalSRSupported = deviceInfo[i].fractionalSRSupported;
 
-            if ((type >= PAL_STREAM_LOW_LATENCY) && (type < PAL_STREAM_MAX))
+            if ((type >= PAL_STREAM_LOW_LATENCY) && (type < PAL_STREAM_MAX) &&
+                streamPriorityLUT.count(type))
                 devinfo->priority = streamPriorityLUT.at(type);
             else
                 devinfo->priority = MIN_USECASE_PRIORITY;
@@ -2564,15 +2612,15 @@ void ResourceManager::getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t
                                 deviceNameLUT.at(deviceId).c_str());
                     }
                     /*parse custom config if there*/
-                    for (int32_t k = 0; k < deviceInfo[i].usecase[j].config.size(); k++) {
-                        if (!deviceInfo[i].usecase[j].config[k].key.compare(key)) {
+                    for (int32_t k = 0; key && k < deviceInfo[i].usecase[j].config.size(); k++) {
+                        if (!deviceInfo[i].usecase[j].config[k].key.compare(*key)) {
                             /*overwrite the channels if needed*/
                             if (deviceInfo[i].usecase[j].config[k].channel) {
                                 devinfo->channels = deviceInfo[i].usecase[j].config[k].channel;
                                 devinfo->channels_overwrite = true;
                                 PAL_VERBOSE(LOG_TAG, "got overwritten channels %d for custom key %s usecase %d for dev %s",
                                         devinfo->channels,
-                                        key.c_str(),
+                                        key->c_str(),
                                         type,
                                         deviceNameLUT.at(deviceId).c_str());
                             }
@@ -2581,7 +2629,7 @@ void ResourceManager::getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t
                                 devinfo->samplerate_overwrite = true;
                                 PAL_VERBOSE(LOG_TAG, "got overwritten samplerate %d for custom key %s usecase %d for dev %s",
                                         devinfo->samplerate,
-                                        key.c_str(),
+                                        key->c_str(),
                                         type,
                                         deviceNameLUT.at(deviceId).c_str());
                             }
@@ -2590,7 +2638,7 @@ void ResourceManager::getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t
                                 devinfo->sndDevName_overwrite = true;
                                 PAL_VERBOSE(LOG_TAG, "got overwitten snd dev %s for custom key %s usecase %d for dev %s",
                                         devinfo->sndDevName.c_str(),
-                                        key.c_str(),
+                                        key->c_str(),
                                         type,
                                         deviceNameLUT.at(deviceId).c_str());
                             }
@@ -2599,7 +2647,7 @@ void ResourceManager::getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t
                                 devinfo->priority = deviceInfo[i].usecase[j].config[k].priority;
                                 PAL_VERBOSE(LOG_TAG, "got priority %d for custom key %s usecase %d for dev %s",
                                         devinfo->priority,
-                                        key.c_str(),
+                                        key->c_str(),
                                         type,
                                         deviceNameLUT.at(deviceId).c_str());
                             }
@@ -2608,11 +2656,10 @@ void ResourceManager::getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t
                                 devinfo->bit_width_overwrite = true;
                                 PAL_VERBOSE(LOG_TAG, "got overwritten bit width %d for custom key %s usecase %d for dev %s",
                                         devinfo->bit_width,
-                                        key.c_str(),
+                                        key->c_str(),
                                         type,
                                         deviceNameLUT.at(deviceId).c_str());
                             }
-                            found = true;
                             break;
                         }
                     }
@@ -2622,6 +2669,80 @@ void ResourceManager::getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t
     }
 }
 
+void ResourceManager::buildDeviceInfoTable()
+{
+    struct device_info_entry *entry = NULL;
+    struct pal_device_info info;
+    pal_device_id_t deviceId;
+    pal_stream_type_t type;
+    bool seen = false;
+
+    deviceInfoIndex.assign(PAL_DEVICE_IN_MAX, -1);
+    deviceInfoTable.clear();
+    deviceInfoTable.resize(deviceInfo.size() * PAL_STREAM_MAX);
+
+    for (int32_t i = 0; i < deviceInfo.size(); i++) {
+        deviceId = (pal_device_id_t)deviceInfo[i].deviceId;
+        if (deviceId < 0 || deviceId >= PAL_DEVICE_IN_MAX) {
+            PAL_ERR(LOG_TAG, "invalid device id %d in device info", deviceId);
+            continue;
+        }
+        /* resolveDeviceInfo already merges repeated entries of a device */
+        if (deviceInfoIndex[deviceId] >= 0)
+            continue;
+        deviceInfoIndex[deviceId] = i;
+
+        for (int32_t t = 0; t < PAL_STREAM_MAX; t++) {
+            type = (pal_stream_type_t)t;
+            entry = &deviceInfoTable[i * PAL_STREAM_MAX + t];
+            resolveDeviceInfo(deviceId, type, NULL, &entry->info);
+            for (auto &dev : deviceInfo) {
+                if (dev.deviceId != deviceId)
+                    continue;
+                for (auto &uc : dev.usecase) {
+                    if (uc.type != t)
+                        continue;
+                    for (auto &cfg : uc.config) {
+                        seen = false;
+                        for (auto &ci : entry->customInfo)
+                            seen |= (ci.first == cfg.key);
+                        if (seen)
+                            continue;
+                        info = {};
+                        resolveDeviceInfo(deviceId, type, &cfg.key, &info);
+                        entry->customInfo.push_back(std::make_pair(cfg.key, info));
+                    }
+                }
+            }
+        }
+    }
+    PAL_DBG(LOG_TAG, "device info table: %zu devices x %d stream types",
+            deviceInfo.size(), PAL_STREAM_MAX);
+}
+
+void ResourceManager::getDeviceInfo(pal_device_id_t deviceId, pal_stream_type_t type,
+                                    const std::string &key, struct pal_device_info *devinfo)
+{
+    struct device_info_entry *entry = NULL;
+
+    if (deviceInfoTable.empty() || type < 0 || type >= PAL_STREAM_MAX ||
+        deviceId < 0 || deviceId >= (int32_t)deviceInfoIndex.size()) {
+        resolveDeviceInfo(deviceId, type, &key, devinfo);
+        return;
+    }
+    if (deviceInfoIndex[deviceId] < 0)
+        return;
+
+    entry = &deviceInfoTable[deviceInfoIndex[deviceId] * PAL_STREAM_MAX + type];
+    for (auto &ci : entry->customInfo) {
+        if (ci.first == key) {
+            *devinfo = ci.second;
+            return;
+        }
+    }
+    *devinfo = entry->info;
+}
+
 int32_t ResourceManager::getSidetoneMode(pal_device_id_t deviceId,
                                          pal_stream_type_t type,
                                          sidetone_mode_t *mode){
@@ -4247,6 +4368,12 @@ int ResourceManager::checkandEnableECForTXStream_l(std::shared_ptr<Device> tx_de
     PAL_DBG(LOG_TAG, "Enter: setting EC[%s] for usecase %d of device %d.",
                       ec_on ? "ON" : "OFF", sAttr.type, tx_dev->getSndDeviceId());
 
+    if (!ec_on) {
+        mECRefMutex.lock();
+        ecRefTxNodes.erase(std::make_pair(tx_stream, (int)tx_dev->getSndDeviceId()));
+        mECRefMutex.unlock();
+    }
+
     status = getECEnableSetting(tx_dev, tx_stream, &ec_enable_setting);
     if (status !=0) {
         PAL_ERR(LOG_TAG, "getECEnableSetting failed.");
@@ -4258,6 +4385,10 @@ int ResourceManager::checkandEnableECForTXStream_l(std::shared_ptr<Device> tx_de
     }
 
     if (ec_on) {
+        mECRefMutex.lock();
+        ecRefTxNodes[std::make_pair(tx_stream, (int)tx_dev->getSndDeviceId())] =
+            ec_ref_tx_node{tx_dev, sAttr.type};
+        mECRefMutex.unlock();
         rx_dev = getActiveEchoReferenceRxDevices_l(tx_stream);
         if (!rx_dev) {
             PAL_VERBOSE(LOG_TAG, "EC device not found, skip EC set");
@@ -4311,13 +4442,13 @@ int ResourceManager::checkandEnableECForRXStream_l(std::shared_ptr<Device> rx_de
                                                    Stream *rx_stream, bool ec_on)
 {
     int status = 0;
+    int ret = 0;
     struct pal_stream_attributes sAttr;
-    std::vector<Stream*> tx_streams_list;
-    std::shared_ptr<Device> tx_dev = nullptr;
-    std::vector<std::shared_ptr<Device>> tx_devices;
+    std::vector<std::pair<Stream *, std::shared_ptr<Device>>> tx_list;
+    std::vector<std::pair<Stream *, std::shared_ptr<Device>>> ec_updates;
+    std::map<Stream *, int> ec_results;
     int ec_map_rx_dev_count = 0;
     int rxdevcount = 0;
-    bool ec_enable_setting = false;
 
     if (!rx_dev || !rx_stream) {
         PAL_ERR(LOG_TAG, "invalid input");
@@ -4333,65 +4464,72 @@ int ResourceManager::checkandEnableECForRXStream_l(std::shared_ptr<Device> rx_de
     PAL_DBG(LOG_TAG, "Enter: setting EC[%s] for usecase %d of device %d.",
                       ec_on ? "ON" : "OFF", sAttr.type, rx_dev->getSndDeviceId());
 
-    tx_streams_list = getConcurrentTxStream_l(rx_stream, rx_dev);
-    for (auto tx_stream: tx_streams_list) {
-        tx_devices.clear();
-        if (!tx_stream || !isStreamActive(tx_stream, mActiveStreams)) {
-            PAL_ERR(LOG_TAG, "TX Stream Empty or is not active\n");
-            continue;
-        }
-        tx_stream->getAssociatedDevices(tx_devices);
-        if (tx_devices.empty()) {
-            PAL_ERR(LOG_TAG, "TX devices Empty\n");
-            continue;
-        }
-        status = tx_stream->getStreamAttributes(&sAttr);
-        if (status) {
-            PAL_ERR(LOG_TAG, "stream get attributes failed");
-            status = -EINVAL;
-            continue;
-        }
-        // TODO: add support for stream with multi Tx devices
-        tx_dev = tx_devices[0];
-        status = getECEnableSetting(tx_dev, tx_stream, &ec_enable_setting);
-        if (status != 0) {
-            PAL_DBG(LOG_TAG, "getECEnableSetting failed.");
-            continue;
-        } else if (!ec_enable_setting) {
-            PAL_ERR(LOG_TAG, "EC is disabled for usecase %d of device %d",
-                              sAttr.type, tx_dev->getSndDeviceId());
-            continue;
-        }
-        ec_map_rx_dev_count = ec_on ? 1 : 0;
+    /*
+     * Only the first Rx stream on a device turns the reference on and only
+     * the last one turns it off, so collect the Tx streams whose edge
+     * actually flips and apply them together below.
+     */
+    ec_map_rx_dev_count = ec_on ? 1 : 0;
+    tx_list = getConcurrentECRefTx_l(rx_stream, rx_dev);
+    for (auto& tx: tx_list) {
+        Stream *tx_stream = tx.first;
+        std::shared_ptr<Device> tx_dev = tx.second;
+
         rxdevcount = updateECDeviceMap(rx_dev, tx_dev, tx_stream, ec_map_rx_dev_count, false);
         if (rxdevcount != ec_map_rx_dev_count) {
             PAL_DBG(LOG_TAG, "Invalid device pair or no need, rxdevcount =%d", rxdevcount);
             continue;
         }
-        mResourceManagerMutex.unlock();
+        ec_updates.push_back(std::make_pair(tx_stream, tx_dev));
+    }
+
+    if (ec_updates.empty())
+        goto exit;
+
+    PAL_DBG(LOG_TAG, "EC[%s] on device %d for %zu Tx streams", ec_on ? "ON" : "OFF",
+            rx_dev->getSndDeviceId(), ec_updates.size());
+    mResourceManagerMutex.unlock();
+    for (auto& update: ec_updates) {
+        Stream *tx_stream = update.first;
+
+        // a stream with several Tx devices on this reference is set once
+        if (ec_results.count(tx_stream)) {
+            if (ec_results[tx_stream] == 0 || !ec_on)
+                update.first = nullptr;
+            continue;
+        }
 #ifdef LINUX_ENABLED
         tx_stream->ecref_op = true;
         if (isDeviceSwitch && tx_stream->isMutexLockedbyRm())
-            status = tx_stream->setECRef_l(rx_dev, ec_on);
+            ret = tx_stream->setECRef_l(rx_dev, ec_on);
         else
-            status = tx_stream->setECRef(rx_dev, ec_on);
+            ret = tx_stream->setECRef(rx_dev, ec_on);
         tx_stream->ecref_op = false;
         tx_stream->ecref_cv.notify_all();
 #else
         if (isDeviceSwitch && tx_stream->isMutexLockedbyRm())
-            status = tx_stream->setECRef_l(rx_dev, ec_on);
+            ret = tx_stream->setECRef_l(rx_dev, ec_on);
         else
-            status = tx_stream->setECRef(rx_dev, ec_on);
+            ret = tx_stream->setECRef(rx_dev, ec_on);
 #endif
-        mResourceManagerMutex.lock();
-        if (status != 0 && ec_on) {
-            if (status == -ENODEV) {
-                status = 0;
-                PAL_VERBOSE(LOG_TAG, "operation is not supported by device, error: %d", status);
-            }
-            // decrease ec ref count if ec ref set failure
-            updateECDeviceMap(rx_dev, tx_devices[0], tx_stream, 0, false);
-        }
+        ec_results[tx_stream] = ret;
+        if (ret == 0)
+            update.first = nullptr;
+        else if (ret == -ENODEV && ec_on)
+            PAL_VERBOSE(LOG_TAG, "operation is not supported by device, error: %d", ret);
+        else
+            status = ret;
+
+        // only a failed enable is rolled back
+        if (!ec_on)
+            update.first = nullptr;
+    }
+    mResourceManagerMutex.lock();
+
+    for (auto& update: ec_updates) {
+        // decrease ec ref count if ec ref set failure
+        if (update.first)
+            updateECDeviceMap(rx_dev, update.second, update.first, 0, false);
     }
 
 exit:
@@ -5184,7 +5322,7 @@ int ResourceManager::registerMixerEventCallback(const std::vector<int> &DevIds,
             }
             mixerEventCallbackMap.insert(std::make_pair(DevIds[i],
                 std::make_pair(callback, cookie)));
-
+            updateMixerEventSlot(DevIds[i], callback, cookie, true);
         }
         mixerEventRegisterCount++;
     } else {
@@ -5195,6 +5333,7 @@ int ResourceManager::registerMixerEventCallback(const std::vector<int> &DevIds,
                     DevIds[i]);
                 if (callback == it->second.first) {
                     mixerEventCallbackMap.erase(it);
+                    updateMixerEventSlot(DevIds[i], callback, cookie, false);
                 } else {
                     PAL_ERR(LOG_TAG, "No matching callback found for pcm id %d",
                         DevIds[i]);
@@ -5210,11 +5349,110 @@ int ResourceManager::registerMixerEventCallback(const std::vector<int> &DevIds,
     return status;
 }
 
+/*
+ * Resolves the event control of pcmId once at registration so the event
+ * thread can dispatch by numid, without parsing the control name.
+ * Called with mResourceManagerMutex held.
+ */
+void ResourceManager::updateMixerEventSlot(int pcmId, session_callback cb,
+                                           uint64_t cookie, bool add)
+{
+    char ctlName[MIXER_PATH_MAX_LENGTH];
+    struct mixer_ctl *ctl = nullptr;
+    struct mixer_event_slot slot;
+
+    if (add && audio_virt_mixer) {
+        snprintf(ctlName, sizeof(ctlName), "PCM%d event", pcmId);
+        ctl = mixer_get_ctl_by_name(audio_virt_mixer, ctlName);
+        if (!ctl) {
+            snprintf(ctlName, sizeof(ctlName), "COMPRESS%d event", pcmId);
+            ctl = mixer_get_ctl_by_name(audio_virt_mixer, ctlName);
+        }
+        if (!ctl)
+            PAL_DBG(LOG_TAG, "no event control for pcm id %d, dispatch by name", pcmId);
+    }
+
+    std::lock_guard<PalMutex> lock(mMixerEventMutex);
+    for (auto it = mixerEventSlots.begin(); it != mixerEventSlots.end(); it++) {
+        if (it->second.pcmId == pcmId) {
+            mixerEventSlots.erase(it);
+            break;
+        }
+    }
+    if (!ctl)
+        return;
+
+    slot.pcmId = pcmId;
+    slot.ctl = ctl;
+    slot.numValues = mixer_ctl_get_num_values(ctl);
+    slot.cb = cb;
+    slot.cookie = cookie;
+    /* tinyalsa ids are 0 based, ALSA numids in ctl events start at 1 */
+    mixerEventSlots[mixer_ctl_get_id(ctl) + 1] = slot;
+}
+
+/*
+ * Returns -ENOENT if numid is not a registered event control, or if the
+ * registered control is not the one named in the event. buf belongs to
+ * the event thread and only grows, so dispatch does not allocate once it
+ * has seen the largest registered control.
+ */
+int ResourceManager::dispatchMixerEvent(unsigned int numid, const char *name,
+                                        std::vector<char> &buf)
+{
+    struct mixer_event_slot slot;
+    struct agm_event_cb_params *params = nullptr;
+    int status = 0;
+
+    {
+        std::lock_guard<PalMutex> lock(mMixerEventMutex);
+        auto it = mixerEventSlots.find(numid);
+        if (it == mixerEventSlots.end())
+            return -ENOENT;
+        slot = it->second;
+    }
+
+    if (mixer_ctl_get_id(slot.ctl) + 1 != numid ||
+        strcmp(name, mixer_ctl_get_name(slot.ctl))) {
+        PAL_ERR(LOG_TAG, "event numid %u (%s) does not match pcm id %d control",
+                numid, name, slot.pcmId);
+        return -ENOENT;
+    }
+
+    if (buf.size() < slot.numValues)
+        buf.resize(slot.numValues);
+    status = mixer_ctl_get_array(slot.ctl, buf.data(), slot.numValues);
+    if (status < 0) {
+        PAL_ERR(LOG_TAG, "Failed to mixer_ctl_get_array for pcm id %d", slot.pcmId);
+        return status;
+    }
+
+    params = (struct agm_event_cb_params *)buf.data();
+    PAL_DBG(LOG_TAG, "pcm id %d source module id %x, event id %d, payload size %d",
+            slot.pcmId, params->source_module_id, params->event_id,
+            params->event_payload_size);
+    if (!params->source_module_id) {
+        PAL_ERR(LOG_TAG, "Invalid source module id");
+        return -EINVAL;
+    }
+
+    if (params->event_id == AGM_EVENT_EARLY_EOS)
+        PAL_DBG(LOG_TAG, "Event will be handled by offload Thread loop");
+    else
+        slot.cb(slot.cookie, params->event_id, (void *)params->event_payload,
+                params->event_payload_size);
+
+    return 0;
+}
+
 void ResourceManager::mixerEventWaitThreadLoop(
     std::shared_ptr<ResourceManager> rm) {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_EVENT, "pal_mixer_evt");
+
     int ret = 0;
     struct ctl_event mixer_event = {0, {.data8 = {0}}};
     struct mixer *mixer = nullptr;
+    std::vector<char> eventBuf;
 
     ret = rm->getVirtualAudioMixer(&mixer);
     if (ret) {
@@ -5234,7 +5472,11 @@ void ResourceManager::mixerEventWaitThreadLoop(
         } else if (ret > 0) {
             ret = mixer_read_event(mixer, &mixer_event);
             if (ret >= 0) {
-                if (strstr((char *)mixer_event.data.elem.id.name, (char *)"event")) {
+                ret = rm->dispatchMixerEvent(mixer_event.data.elem.id.numid,
+                        (const char *)mixer_event.data.elem.id.name, eventBuf);
+                if (ret != -ENOENT) {
+                    PAL_VERBOSE(LOG_TAG, "Event dispatched by numid, ret %d", ret);
+                } else if (strstr((char *)mixer_event.data.elem.id.name, (char *)"event")) {
                     PAL_INFO(LOG_TAG, "Event Received %s",
                              mixer_event.data.elem.id.name);
                     ret = rm->handleMixerEvent(mixer,
@@ -5530,10 +5772,17 @@ void ResourceManager::HandleStreamPauseResume(pal_stream_type_t st_type, bool ac
     }
 }
 
-/* This function should be called with mActiveStreamMutex lock acquired */
+/*
+ * This function should be called with mActiveStreamMutex lock acquired.
+ * Only streams whose capture profile changes with the new LPI/NLPI state
+ * are stopped and restarted, the others keep running untouched.
+ */
 void ResourceManager::handleConcurrentStreamSwitch(std::vector<pal_stream_type_t>& st_streams)
 {
     std::shared_ptr<CaptureProfile> cap_prof_priority = nullptr;
+    std::vector<Stream *> switch_streams;
+    struct pal_stream_attributes st_attr;
+    uint32_t unaffected = 0;
 
     // update common capture profile after use_lpi_ updated for all streams
     if (st_streams.size()) {
@@ -5549,20 +5798,36 @@ void ResourceManager::handleConcurrentStreamSwitch(std::vector<pal_stream_type_t
         }
     }
 
-    for (pal_stream_type_t st_stream_type_to_stop : st_streams) {
-        // stop/unload SVA/ACD/Sensor PCM Data streams
-        bool action = false;
-        PAL_DBG(LOG_TAG, "stop/unload stream type %d", st_stream_type_to_stop);
-        HandleDetectionStreamAction(st_stream_type_to_stop,
-            ST_HANDLE_CONCURRENT_STREAM, (void *)&action);
+    // keep the stop/start order grouped by stream type
+    for (pal_stream_type_t st_stream_type : st_streams) {
+        for (auto& str: mActiveStreams) {
+            if (!isStreamActive(str, mActiveStreams))
+                continue;
+
+            str->getStreamAttributes(&st_attr);
+            if (st_attr.type != st_stream_type)
+                continue;
+
+            if (str->IsCaptureProfileChanged())
+                switch_streams.push_back(str);
+            else
+                unaffected++;
+        }
+    }
+
+    PAL_INFO(LOG_TAG, "%s switch: %zu detection streams to reconfigure, %u unaffected",
+        use_lpi_ ? "NLPI->LPI" : "LPI->NLPI", switch_streams.size(), unaffected);
+
+    for (auto& str: switch_streams) {
+        // stop/unload SVA/ACD/Sensor PCM Data stream
+        if (str->HandleConcurrentStream(false))
+            PAL_ERR(LOG_TAG, "Failed to stop/unload stream");
     }
 
-    for (pal_stream_type_t st_stream_type_to_start : st_streams) {
-        // load/start SVA/ACD/Sensor PCM Data streams
-        bool action = true;
-        PAL_DBG(LOG_TAG, "load/start stream type %d", st_stream_type_to_start);
-        HandleDetectionStreamAction(st_stream_type_to_start,
-            ST_HANDLE_CONCURRENT_STREAM, (void *)&action);
+    for (auto& str: switch_streams) {
+        // load/start SVA/ACD/Sensor PCM Data stream
+        if (str->HandleConcurrentStream(true))
+            PAL_ERR(LOG_TAG, "Failed to load/start stream");
     }
 }
 
@@ -5685,6 +5950,13 @@ void ResourceManager::HandleConcurrencyForSoundTriggerStreams(pal_stream_type_t
                 if ((PAL_STREAM_VOICE_UI == st_stream_type && ++concurrencyEnableCount == 1) ||
                     (PAL_STREAM_ACD == st_stream_type && ++ACDConcurrencyEnableCount == 1) ||
                     (PAL_STREAM_SENSOR_PCM_DATA == st_stream_type && ++SNSPCMDataConcurrencyEnableCount == 1)) {
+                    if (lpiRestorePending) {
+                        // still in NLPI, drop the held back switch to LPI
+                        TimerScheduler::getInstance()->cancel(lpiRestoreTimer);
+                        lpiRestoreTimer = 0;
+                        lpiRestorePending = false;
+                        PAL_INFO(LOG_TAG, "Concurrency restarted, coalesced NLPI->LPI->NLPI switch");
+                    }
                     if (use_lpi_temp) {
                         do_st_stream_switch = true;
                         use_lpi_temp = false;
@@ -5711,6 +5983,21 @@ void ResourceManager::HandleConcurrencyForSoundTriggerStreams(pal_stream_type_t
     if (SNSPCMDataConcurrencyEnableCount < 0)
         SNSPCMDataConcurrencyEnableCount = 0;
 
+    if (do_st_stream_switch && !active && use_lpi_temp && !use_lpi_) {
+        /*
+         * Hold back the switch to LPI so that a concurrency which stops and
+         * starts again in quick succession (e.g. back to back recordings)
+         * costs no detection stream transition at all.
+         */
+        TimerScheduler::getInstance()->reschedule(&lpiRestoreTimer, ST_LPI_RESTORE_HOLD_MS,
+                                                  onLpiRestoreTimeout, this);
+        if (lpiRestoreTimer) {
+            PAL_DBG(LOG_TAG, "NLPI->LPI switch held for %d ms", ST_LPI_RESTORE_HOLD_MS);
+            lpiRestorePending = true;
+            do_st_stream_switch = false;
+        }
+    }
+
     if (do_st_stream_switch) {
         if (checkAndUpdateDeferSwitchState(active)) {
             PAL_DBG(LOG_TAG, "Switch is deferred");
@@ -5724,6 +6011,59 @@ void ResourceManager::HandleConcurrencyForSoundTriggerStreams(pal_stream_type_t
     PAL_DBG(LOG_TAG, "Exit");
 }
 
+void ResourceManager::onLpiRestoreTimeout(void *cookie)
+{
+    ResourceManager *rm = (ResourceManager *)cookie;
+    OffloadWorkerPool *pool = OffloadWorkerPool::getInstance();
+
+    /* a detection stream switch takes long, keep the UPD gain and charger timers on time */
+    if (pool->attach(&rm->lpiRestoreTask, runLpiRestore, rm) == 0 &&
+        pool->post(&rm->lpiRestoreTask, 0) == 0)
+        return;
+
+    PAL_ERR(LOG_TAG, "failed to queue NLPI->LPI switch, running it inline");
+    runLpiRestore(rm, 0);
+}
+
+void ResourceManager::runLpiRestore(void *cookie, int /*cmd*/)
+{
+    ResourceManager *rm = (ResourceManager *)cookie;
+    std::vector<pal_stream_type_t> st_streams;
+
+    mActiveStreamMutex.lock();
+    // a concurrency that started meanwhile has already cancelled the switch
+    if (!rm->lpiRestorePending)
+        goto exit;
+
+    rm->lpiRestorePending = false;
+    rm->lpiRestoreTimer = 0;
+
+    if (rm->use_lpi_) {
+        PAL_DBG(LOG_TAG, "Already in LPI, skip held back switch");
+        goto exit;
+    }
+
+    if (rm->active_streams_st.size() && rm->charging_state_ &&
+        rm->IsTransitToNonLPIOnChargingSupported()) {
+        PAL_DBG(LOG_TAG, "Stay in NLPI while charging");
+        goto exit;
+    }
+
+    st_streams.push_back(PAL_STREAM_VOICE_UI);
+    st_streams.push_back(PAL_STREAM_ACD);
+    st_streams.push_back(PAL_STREAM_SENSOR_PCM_DATA);
+
+    if (rm->checkAndUpdateDeferSwitchState(false)) {
+        PAL_DBG(LOG_TAG, "Switch is deferred");
+    } else {
+        rm->use_lpi_ = true;
+        rm->handleConcurrentStreamSwitch(st_streams);
+    }
+
+exit:
+    mActiveStreamMutex.unlock();
+}
+
 std::shared_ptr<Device> ResourceManager::getActiveEchoReferenceRxDevices_l(
     Stream *tx_str)
 {
@@ -5807,17 +6147,18 @@ std::shared_ptr<Device> ResourceManager::getActiveEchoReferenceRxDevices(
     return rx_device;
 }
 
-std::vector<Stream*> ResourceManager::getConcurrentTxStream_l(
+/*
+ * Tx streams and Tx devices that can take rx_device as EC reference for
+ * rx_str. Only the EC enabled nodes of the reference graph are visited,
+ * see checkandEnableECForTXStream_l.
+ */
+std::vector<std::pair<Stream *, std::shared_ptr<Device>>> ResourceManager::getConcurrentECRefTx_l(
     Stream *rx_str,
     std::shared_ptr<Device> rx_device)
 {
-    int deviceId = 0;
     int status = 0;
-    std::vector<Stream*> tx_stream_list;
-    struct pal_stream_attributes tx_attr;
+    std::vector<std::pair<Stream *, std::shared_ptr<Device>>> tx_list;
     struct pal_stream_attributes rx_attr;
-    std::shared_ptr<Device> tx_device = nullptr;
-    std::vector <std::shared_ptr<Device>> tx_device_list;
 
     // check stream direction
     status = rx_str->getStreamAttributes(&rx_attr);
@@ -5832,38 +6173,37 @@ std::vector<Stream*> ResourceManager::getConcurrentTxStream_l(
         goto exit;
     }
 
-    for (auto& tx_str: mActiveStreams) {
-        tx_device_list.clear();
-        tx_str->getStreamAttributes(&tx_attr);
-        if (tx_attr.type == PAL_STREAM_PROXY ||
-            tx_attr.type == PAL_STREAM_ULTRA_LOW_LATENCY ||
-            tx_attr.type == PAL_STREAM_GENERIC)
+    mECRefMutex.lock();
+    for (auto node = ecRefTxNodes.begin(); node != ecRefTxNodes.end();) {
+        if (!isStreamActive(node->first.first, mActiveStreams)) {
+            PAL_DBG(LOG_TAG, "drop EC ref node of inactive stream %pK", node->first.first);
+            node = ecRefTxNodes.erase(node);
             continue;
-        if (tx_attr.direction == PAL_AUDIO_INPUT) {
-            if (!getEcRefStatus(tx_attr.type, rx_attr.type)) {
-                PAL_DBG(LOG_TAG, "No need to enable ec ref for rx %d tx %d",
-                        rx_attr.type, tx_attr.type);
-                continue;
-            }
-            tx_str->getAssociatedDevices(tx_device_list);
-            for (int i = 0; i < tx_device_list.size(); i++) {
-                if (!isDeviceActive_l(tx_device_list[i], tx_str))
-                    continue;
-                deviceId = tx_device_list[i]->getSndDeviceId();
-                if (deviceId > PAL_DEVICE_IN_MIN &&
-                    deviceId < PAL_DEVICE_IN_MAX)
-                    tx_device = tx_device_list[i];
-                else
-                    tx_device = nullptr;
-
-                if (checkECRef(rx_device, tx_device)) {
-                    tx_stream_list.push_back(tx_str);
-                    break;
-                }
-            }
         }
+        if (!getEcRefStatus(node->second.type, rx_attr.type)) {
+            PAL_DBG(LOG_TAG, "No need to enable ec ref for rx %d tx %d",
+                    rx_attr.type, node->second.type);
+        } else if (checkECRef(rx_device, node->second.txDev)) {
+            tx_list.push_back(std::make_pair(node->first.first, node->second.txDev));
+        }
+        node++;
     }
+    mECRefMutex.unlock();
 exit:
+    return tx_list;
+}
+
+std::vector<Stream*> ResourceManager::getConcurrentTxStream_l(
+    Stream *rx_str,
+    std::shared_ptr<Device> rx_device)
+{
+    std::vector<Stream*> tx_stream_list;
+
+    for (auto& tx: getConcurrentECRefTx_l(rx_str, rx_device)) {
+        if (std::find(tx_stream_list.begin(), tx_stream_list.end(), tx.first) ==
+            tx_stream_list.end())
+            tx_stream_list.push_back(tx.first);
+    }
     return tx_stream_list;
 }
 
@@ -5915,12 +6255,8 @@ bool ResourceManager::checkECRef(std::shared_ptr<Device> rx_dev,
 int ResourceManager::updateECDeviceMap_l(std::shared_ptr<Device> rx_dev,
     std::shared_ptr<Device> tx_dev, Stream *tx_str, int count, bool is_txstop)
 {
-    int status = 0;
-    mResourceManagerMutex.lock();
-    status = updateECDeviceMap(rx_dev, tx_dev, tx_str, count, is_txstop);
-    mResourceManagerMutex.unlock();
-
-    return status;
+    /* the EC ref map has its own lock, see updateECDeviceMap */
+    return updateECDeviceMap(rx_dev, tx_dev, tx_str, count, is_txstop);
 }
 
 
@@ -5930,10 +6266,9 @@ int ResourceManager::updateECDeviceMap(std::shared_ptr<Device> rx_dev,
     int rx_dev_id = 0;
     int tx_dev_id = 0;
     int ec_count = 0;
-    int i = 0, j = 0;
     bool tx_stream_found = false;
-    std::vector<std::pair<Stream *, int>>::iterator iter;
-    std::map<int, std::vector<std::pair<Stream *, int>>>::iterator map_iter;
+    std::map<std::pair<Stream *, int>, std::map<int, int>>::iterator node;
+    std::map<int, int>::iterator edge;
 
     if ((!rx_dev && !is_txstop) || !tx_dev || !tx_str) {
         PAL_ERR(LOG_TAG, "Invalid operation");
@@ -5941,56 +6276,41 @@ int ResourceManager::updateECDeviceMap(std::shared_ptr<Device> rx_dev,
     }
 
     tx_dev_id = tx_dev->getSndDeviceId();
-    for (i = 0; i < deviceInfo.size(); i++) {
-        if (tx_dev_id == deviceInfo[i].deviceId) {
-            break;
-        }
-    }
-
-    if (i == deviceInfo.size()) {
-        PAL_ERR(LOG_TAG, "Tx device %d not found", tx_dev_id);
-        return -EINVAL;
-    }
 
+    std::lock_guard<PalMutex> lock(mECRefMutex);
+    node = ecRefEdges.find(std::make_pair(tx_str, tx_dev_id));
     if (is_txstop) {
-        for (map_iter = deviceInfo[i].ec_ref_count_map.begin();
-            map_iter != deviceInfo[i].ec_ref_count_map.end(); map_iter++) {
-            rx_dev_id = (*map_iter).first;
-            if (rx_dev && rx_dev->getSndDeviceId() != rx_dev_id)
-                continue;
-            for (iter = deviceInfo[i].ec_ref_count_map[rx_dev_id].begin();
-                iter != deviceInfo[i].ec_ref_count_map[rx_dev_id].end(); iter++) {
-                if ((*iter).first == tx_str) {
-                    tx_stream_found = true;
-                    deviceInfo[i].ec_ref_count_map[rx_dev_id].erase(iter);
-                    ec_count = 0;
-                    break;
-                }
+        if (node != ecRefEdges.end()) {
+            if (rx_dev) {
+                rx_dev_id = rx_dev->getSndDeviceId();
+                tx_stream_found = node->second.erase(rx_dev_id) > 0;
+            } else {
+                // drop every reference of the stopping Tx stream
+                tx_stream_found = !node->second.empty();
+                node->second.clear();
             }
-            if (tx_stream_found && rx_dev)
-                break;
+            if (node->second.empty())
+                ecRefEdges.erase(node);
         }
     } else {
         // rx_dev cannot be null if is_txstop is false
         rx_dev_id = rx_dev->getSndDeviceId();
 
-        for (iter = deviceInfo[i].ec_ref_count_map[rx_dev_id].begin();
-            iter != deviceInfo[i].ec_ref_count_map[rx_dev_id].end(); iter++) {
-            if ((*iter).first == tx_str) {
-                tx_stream_found = true;
-                if (count > 0) {
-                    (*iter).second += count;
-                    ec_count = (*iter).second;
-                } else if (count == 0) {
-                    if ((*iter).second > 0) {
-                        (*iter).second--;
-                    }
-                    ec_count = (*iter).second;
-                    if ((*iter).second == 0) {
-                        deviceInfo[i].ec_ref_count_map[rx_dev_id].erase(iter);
-                    }
+        if (node != ecRefEdges.end() &&
+            (edge = node->second.find(rx_dev_id)) != node->second.end()) {
+            tx_stream_found = true;
+            if (count > 0) {
+                edge->second += count;
+                ec_count = edge->second;
+            } else if (count == 0) {
+                if (edge->second > 0)
+                    edge->second--;
+                ec_count = edge->second;
+                if (edge->second == 0) {
+                    node->second.erase(edge);
+                    if (node->second.empty())
+                        ecRefEdges.erase(node);
                 }
-                break;
             }
         }
     }
@@ -6000,8 +6320,7 @@ int ResourceManager::updateECDeviceMap(std::shared_ptr<Device> rx_dev,
             PAL_ERR(LOG_TAG, "Cannot reset as ec ref not present");
             return -EINVAL;
         } else if (count > 0) {
-            deviceInfo[i].ec_ref_count_map[rx_dev_id].push_back(
-                std::make_pair(tx_str, count));
+            ecRefEdges[std::make_pair(tx_str, tx_dev_id)][rx_dev_id] = count;
             ec_count = count;
         }
     }
@@ -6014,47 +6333,37 @@ int ResourceManager::updateECDeviceMap(std::shared_ptr<Device> rx_dev,
 std::shared_ptr<Device> ResourceManager::clearInternalECRefCounts(Stream *tx_str,
     std::shared_ptr<Device> tx_dev)
 {
-    int i = 0;
-    int rx_dev_id = 0;
-    int tx_dev_id = 0;
+    int ec_rx_dev_id = 0;
     struct pal_device palDev;
     std::shared_ptr<Device> rx_dev = nullptr;
-    std::vector<std::pair<Stream *, int>>::iterator iter;
-    std::map<int, std::vector<std::pair<Stream *, int>>>::iterator map_iter;
+    std::map<std::pair<Stream *, int>, std::map<int, int>>::iterator node;
 
     if (!tx_str || !tx_dev) {
         PAL_ERR(LOG_TAG, "Invalid operation");
         goto exit;
     }
 
-    tx_dev_id = tx_dev->getSndDeviceId();
-    for (i = 0; i < deviceInfo.size(); i++) {
-        if (tx_dev_id == deviceInfo[i].deviceId) {
-            break;
+    mECRefMutex.lock();
+    node = ecRefEdges.find(std::make_pair(tx_str, (int)tx_dev->getSndDeviceId()));
+    if (node != ecRefEdges.end()) {
+        for (auto edge = node->second.begin(); edge != node->second.end();) {
+            if (isExternalECRefEnabled(edge->first)) {
+                edge++;
+                continue;
+            }
+            if (edge->second > 0)
+                ec_rx_dev_id = edge->first;
+            edge = node->second.erase(edge);
         }
+        if (node->second.empty())
+            ecRefEdges.erase(node);
     }
+    mECRefMutex.unlock();
 
-    if (i == deviceInfo.size()) {
-        PAL_ERR(LOG_TAG, "Tx device %d not found", tx_dev_id);
-        goto exit;
-    }
-
-    for (map_iter = deviceInfo[i].ec_ref_count_map.begin();
-        map_iter != deviceInfo[i].ec_ref_count_map.end(); map_iter++) {
-        rx_dev_id = (*map_iter).first;
-        if (isExternalECRefEnabled(rx_dev_id))
-            continue;
-        for (iter = deviceInfo[i].ec_ref_count_map[rx_dev_id].begin();
-            iter != deviceInfo[i].ec_ref_count_map[rx_dev_id].end(); iter++) {
-            if ((*iter).first == tx_str) {
-                if ((*iter).second > 0) {
-                    palDev.id = (pal_device_id_t)rx_dev_id;
-                    rx_dev = Device::getInstance(&palDev, rm);
-                }
-                deviceInfo[i].ec_ref_count_map[rx_dev_id].erase(iter);
-                break;
-            }
-        }
+    /* device lookup takes other locks, keep it outside the EC ref lock */
+    if (ec_rx_dev_id) {
+        palDev.id = (pal_device_id_t)ec_rx_dev_id;
+        rx_dev = Device::getInstance(&palDev, rm);
     }
 
 exit:
@@ -6774,7 +7083,7 @@ void ResourceManager::checkAndSetDutyCycleParam()
 std::shared_ptr<ResourceManager> ResourceManager::getInstance()
 {
     if(!rm) {
-        std::lock_guard<std::mutex> lock(ResourceManager::mResourceManagerMutex);
+        std::lock_guard<PalMutex> lock(ResourceManager::mResourceManagerMutex);
         if (!rm) {
             std::shared_ptr<ResourceManager> sp(new ResourceManager());
             rm = sp;
@@ -6857,6 +7166,13 @@ void ResourceManager::deinit()
         mixerEventTread.join();
     }
     PAL_DBG(LOG_TAG, "Mixer event thread joined");
+    /* the handlers dereference rm, let a running one finish before teardown */
+    TimerScheduler::getInstance()->cancelSync(chargerInsertionTimer.exchange(0));
+    if (rm) {
+        TimerScheduler::getInstance()->cancelSync(rm->updGainTimer);
+        TimerScheduler::getInstance()->cancelSync(rm->lpiRestoreTimer);
+        OffloadWorkerPool::getInstance()->detach(&rm->lpiRestoreTask);
+    }
     if (sndmon)
         delete sndmon;
 
@@ -8116,6 +8432,103 @@ int32_t ResourceManager::streamDevConnect_l(std::vector <std::tuple<Stream *, st
 }
 
 
+/*
+ * Make-before-break switch for a started voice call moving between devices
+ * on separate backends: all new legs are brought up first, then each one
+ * replaces its old leg in a single disconnect/connect. Returns -ENOTSUP
+ * without touching anything when the switch does not qualify, so that the
+ * caller falls back to disconnecting and reconnecting.
+ */
+int32_t ResourceManager::streamDevSwitchMbb_l(
+        std::vector <std::tuple<Stream *, uint32_t>> &streamDevDisconnectList,
+        std::vector <std::tuple<Stream *, struct pal_device *>> &streamDevConnectList)
+{
+    int32_t status = 0;
+    Stream *s = nullptr;
+    struct pal_stream_attributes sAttr;
+    struct pal_device_info oldInfo = {}, newInfo = {};
+    std::vector <std::pair<pal_device_id_t, struct pal_device *>> legs;
+    std::vector <std::shared_ptr<Device>> newDevs;
+    std::vector <bool> used(streamDevConnectList.size(), false);
+    std::chrono::steady_clock::time_point phaseStart;
+    uint32_t prepareMs = 0, gapMs = 0;
+    auto isOut = [](uint32_t id) { return id > PAL_DEVICE_OUT_MIN && id < PAL_DEVICE_OUT_MAX; };
+
+    if (streamDevDisconnectList.empty() ||
+        streamDevDisconnectList.size() != streamDevConnectList.size())
+        return -ENOTSUP;
+
+    s = std::get<0>(streamDevDisconnectList[0]);
+    for (auto &elem : streamDevDisconnectList) {
+        if (std::get<0>(elem) != s)
+            return -ENOTSUP;
+    }
+    for (auto &elem : streamDevConnectList) {
+        if (std::get<0>(elem) != s)
+            return -ENOTSUP;
+    }
+    if (!s || !isStreamActive(s, mActiveStreams) || PAL_CARD_STATUS_DOWN(cardState) ||
+        s->getStreamAttributes(&sAttr) || sAttr.type != PAL_STREAM_VOICE_CALL ||
+        !s->isActive())
+        return -ENOTSUP;
+
+    /* pair each old device with the new one of the same direction */
+    for (auto &elem : streamDevDisconnectList) {
+        pal_device_id_t oldId = (pal_device_id_t)std::get<1>(elem);
+        struct pal_device *newAttr = nullptr;
+
+        for (int i = 0; i < streamDevConnectList.size(); i++) {
+            struct pal_device *cand = std::get<1>(streamDevConnectList[i]);
+            if (!used[i] && isOut(cand->id) == isOut(oldId)) {
+                used[i] = true;
+                newAttr = cand;
+                break;
+            }
+        }
+        if (!newAttr || newAttr->id == oldId)
+            return -ENOTSUP;
+        /* both legs would share the one external EC ref graph, keep the regular path */
+        if (isOut(oldId)) {
+            getDeviceInfo(oldId, sAttr.type, "", &oldInfo);
+            getDeviceInfo(newAttr->id, sAttr.type, newAttr->custom_config.custom_key, &newInfo);
+            if (oldInfo.isExternalECRefEnabledFlag && newInfo.isExternalECRefEnabledFlag)
+                return -ENOTSUP;
+        }
+        legs.push_back({oldId, newAttr});
+    }
+
+    phaseStart = std::chrono::steady_clock::now();
+    for (auto &leg : legs) {
+        std::shared_ptr<Device> dev = nullptr;
+
+        status = s->prepareStreamDevice_l(s, leg.second, dev);
+        if (status) {
+            PAL_INFO(LOG_TAG, "cannot prepare device %d ahead (%d), switching after teardown",
+                     leg.second->id, status);
+            for (auto &prepared : newDevs)
+                s->abortStreamDevice_l(s, prepared);
+            return -ENOTSUP;
+        }
+        newDevs.push_back(dev);
+    }
+    prepareMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - phaseStart).count();
+
+    for (int i = 0; i < legs.size(); i++) {
+        int32_t ret = s->commitStreamDevice_l(s, legs[i].first, newDevs[i], &gapMs);
+        if (ret) {
+            PAL_ERR(LOG_TAG, "switching device %d to %d failed %d",
+                    legs[i].first, legs[i].second->id, ret);
+            s->abortStreamDevice_l(s, newDevs[i]);
+            status = ret;
+            continue;
+        }
+        PAL_INFO(LOG_TAG, "voice device %d -> %d: prepared in %u ms, gap %u ms",
+                 legs[i].first, legs[i].second->id, prepareMs, gapMs);
+    }
+    return status;
+}
+
 template <class T>
 void SortAndUnique(std::vector<T> &streams)
 {
@@ -8137,8 +8550,11 @@ int32_t ResourceManager::streamDevSwitch(std::vector <std::tuple<Stream *, uint3
     std::vector <Stream*> uniqueStreamsList;
     std::vector <struct pal_device *> uniqueDevConnectionList;
     pal_stream_attributes sAttr;
+    std::chrono::steady_clock::time_point switchStart;
 
     PAL_INFO(LOG_TAG, "Enter");
+    /* backends get reconfigured, parked warm streams would go stale */
+    WarmStreamPool::invalidate();
 
     mActiveStreamMutex.lock();
 
@@ -8206,6 +8622,11 @@ int32_t ResourceManager::streamDevSwitch(std::vector <std::tuple<Stream *, uint3
         }
     }
 
+    status = streamDevSwitchMbb_l(streamDevDisconnectList, streamDevConnectList);
+    if (status != -ENOTSUP)
+        goto exit;
+
+    switchStart = std::chrono::steady_clock::now();
     status = streamDevDisconnect_l(streamDevDisconnectList);
     if (status) {
         PAL_ERR(LOG_TAG, "disconnect failed");
@@ -8215,6 +8636,10 @@ int32_t ResourceManager::streamDevSwitch(std::vector <std::tuple<Stream *, uint3
     if (status) {
         PAL_ERR(LOG_TAG, "Connect failed");
     }
+    /* same metric as the make-before-break path, for comparison */
+    PAL_INFO(LOG_TAG, "device switch after teardown: gap %u ms",
+             (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - switchStart).count());
 
     for (sIter2 = streamDevConnectList.begin(); sIter2 != streamDevConnectList.end(); sIter2++) {
         if ((std::get<0>(*sIter2) != NULL) && isStreamActive(std::get<0>(*sIter2), mActiveStreams)) {
@@ -8752,6 +9177,8 @@ int ResourceManager::setConfigParams(struct str_parms *parms)
         PAL_ERR(LOG_TAG," key-value pair is NULL");
         goto exit;
     }
+    /* config params can change device configs, drop parked warm streams */
+    WarmStreamPool::invalidate();
 
     len = strlen(kv_pairs);
     value = (char*)calloc(len, sizeof(char));
@@ -8770,6 +9197,7 @@ int ResourceManager::setConfigParams(struct str_parms *parms)
     ret = setUpdCustomGainParam(parms, value, len);
     ret = setDualMonoEnableParam(parms, value, len);
     ret = setSignalHandlerEnableParam(parms, value, len);
+    setWarmStreamPoolParam(parms, value, len);
     ret = setMuxconfigEnableParam(parms, value, len);
     ret = setUpdDutyCycleEnableParam(parms, value, len);
     ret = setUpdVirtualPortParam(parms, value, len);
@@ -9098,6 +9526,32 @@ int ResourceManager::setSignalHandlerEnableParam(struct str_parms *parms,
     return ret;
 }
 
+int ResourceManager::setWarmStreamPoolParam(struct str_parms *parms,
+                                 char *value, int len)
+{
+    int ret = -EINVAL;
+
+    if (!value || !parms)
+        return ret;
+
+    ret = str_parms_get_str(parms, AUDIO_PARAMETER_KEY_WARM_STREAM_POOL,
+                                value, len);
+    PAL_VERBOSE(LOG_TAG," value %s", value);
+    if (ret >= 0) {
+        WarmStreamPool::setPoolSize((uint32_t)atoi(value));
+        str_parms_del(parms, AUDIO_PARAMETER_KEY_WARM_STREAM_POOL);
+    }
+
+    ret = str_parms_get_str(parms, AUDIO_PARAMETER_KEY_WARM_STREAM_IDLE,
+                                value, len);
+    if (ret >= 0) {
+        WarmStreamPool::setIdleTimeout((uint32_t)atoi(value));
+        str_parms_del(parms, AUDIO_PARAMETER_KEY_WARM_STREAM_IDLE);
+    }
+
+    return ret;
+}
+
 int ResourceManager::setNativeAudioParams(struct str_parms *parms,
                                           char *value, int len)
 {
@@ -9249,16 +9703,107 @@ int ResourceManager::convertCharToHex(std::string num)
     return (int32_t) hexNum;
 }
 
+static uint32_t a2dpPhaseMs(std::chrono::steady_clock::time_point &since)
+{
+    auto now = std::chrono::steady_clock::now();
+    uint32_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - since).count();
+
+    since = now;
+    return ms;
+}
+
+static uint64_t sessionTimeUs(const pal_timestamp_info_t &info)
+{
+    return ((uint64_t)info.stime.session_time.value_msw << 32) |
+           info.stime.session_time.value_lsw;
+}
+
+/* call with the stream muted and its mutex held */
+void ResourceManager::addMutedDrain_l(Stream *s, std::vector<struct muted_drain_entry> &pending)
+{
+    struct muted_drain_entry entry;
+    pal_timestamp_info_t info;
+
+    entry.s = s;
+    entry.latencyMs = s->getLatency();
+    if (entry.latencyMs == 0)
+        return;
+    entry.muteTime = std::chrono::steady_clock::now();
+    entry.tracked = (s->getTimestampInfo(&info, true) == 0);
+    entry.startUs = entry.tracked ? sessionTimeUs(info) : 0;
+    entry.lastUs = entry.startUs;
+    entry.deadline = entry.muteTime +
+                     std::chrono::milliseconds(entry.latencyMs + A2DP_DRAIN_SLACK_MS);
+    pending.push_back(entry);
+}
+
+/*
+ * Waits until the data queued ahead of the mute on each stream has been
+ * rendered, judged by the SPR session time, read fresh from the DSP,
+ * advancing by the stream latency. Streams that are closed meanwhile are
+ * dropped. Each stream gives up A2DP_DRAIN_SLACK_MS after its remaining
+ * latency, as measured when its session time last advanced, has elapsed;
+ * untracked streams measure it at mute. Session time stalls while a2dp is
+ * suspended, so stalled streams hit that bound rather than draining.
+ */
+void ResourceManager::waitMutedDrain(std::vector<struct muted_drain_entry> &pending)
+{
+    pal_timestamp_info_t info;
+    std::chrono::steady_clock::time_point now, wake;
+    uint64_t playedUs = 0;
+    bool drained = false;
+
+    while (!pending.empty()) {
+        now = std::chrono::steady_clock::now();
+        wake = now + std::chrono::milliseconds(A2DP_DRAIN_POLL_MS);
+        mActiveStreamMutex.lock();
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (!isStreamActive(it->s, mActiveStreams)) {
+                drained = true;
+            } else if (it->tracked && it->s->getTimestampInfo(&info, true) == 0) {
+                playedUs = sessionTimeUs(info) - it->startUs;
+                drained = (playedUs >= it->latencyMs * 1000ULL);
+                if (!drained && sessionTimeUs(info) != it->lastUs) {
+                    /* progress, rebase the bound on what is left to play */
+                    it->lastUs = sessionTimeUs(info);
+                    it->deadline = now + std::chrono::milliseconds(
+                                   (it->latencyMs * 1000ULL - playedUs) / 1000 +
+                                   A2DP_DRAIN_SLACK_MS);
+                }
+            } else {
+                it->tracked = false;
+                drained = false;
+            }
+            if (!drained && now >= it->deadline) {
+                PAL_DBG(LOG_TAG, "stream %pK not drained, %s", it->s,
+                        it->tracked ? "session time stalled" : "session time unavailable");
+                drained = true;
+            }
+            if (!drained && !it->tracked)
+                wake = std::min(wake, it->deadline);
+            it = drained ? pending.erase(it) : it + 1;
+        }
+        mActiveStreamMutex.unlock();
+        if (!pending.empty())
+            std::this_thread::sleep_until(wake);
+    }
+}
+
 int32_t ResourceManager::a2dpReconfig()
 {
     int status = 0;
-    uint32_t latencyMs = 0, maxLatencyMs = 0;
+    int switchStatus = 0;
     std::shared_ptr<Device> a2dpDev = nullptr;
+    std::shared_ptr<BtA2dp> btA2dp = nullptr;
     struct pal_device a2dpDattr;
     std::vector <Stream*> activeA2dpStreams;
     std::vector <Stream*> activeStreams;
     std::vector <Stream*>::iterator sIter;
+    std::vector <struct muted_drain_entry> drainStreams;
     struct pal_volume_data* volume = NULL;
+    std::chrono::steady_clock::time_point phaseStart;
+    uint32_t muteMs = 0, drainMs = 0, readyMs = 0, switchMs = 0, restoreMs = 0;
+    int retry = 0;
 
     PAL_DBG(LOG_TAG, "enter");
     volume = (struct pal_volume_data*)calloc(1, (sizeof(uint32_t) +
@@ -9268,6 +9813,7 @@ int32_t ResourceManager::a2dpReconfig()
         goto exit;
     }
 
+    phaseStart = std::chrono::steady_clock::now();
     mActiveStreamMutex.lock();
 
     a2dpDattr.id = PAL_DEVICE_OUT_BLUETOOTH_A2DP;
@@ -9314,12 +9860,10 @@ int32_t ResourceManager::a2dpReconfig()
                         (*sIter)->a2dpPaused = true;
                     }
                 } else {
-                    latencyMs = (*sIter)->getLatency();
-                    if (maxLatencyMs < latencyMs)
-                        maxLatencyMs = latencyMs;
                     // Mute
                     (*sIter)->mute_l(true);
                     (*sIter)->a2dpMuted = true;
+                    addMutedDrain_l(*sIter, drainStreams);
                 }
             }
             (*sIter)->unlockStreamMutex();
@@ -9327,16 +9871,30 @@ int32_t ResourceManager::a2dpReconfig()
     }
 
     mActiveStreamMutex.unlock();
+    muteMs = a2dpPhaseMs(phaseStart);
 
-    // wait for stale pcm drained before switching to speaker
-    if (maxLatencyMs > 0) {
-        // multiplication factor applied to latency when calculating a safe mute delay
-        // TODO: It's not needed if latency is accurate.
-        const int latencyMuteFactor = 2;
-        usleep(maxLatencyMs * 1000 * latencyMuteFactor);
-    }
+    // wait for stale pcm drained before switching
+    waitMutedDrain(drainStreams);
+    drainMs = a2dpPhaseMs(phaseStart);
 
-    forceDeviceSwitch(a2dpDev, &a2dpDattr);
+    /* the switch back to a2dp fails while the BT stack is still reconfiguring */
+    btA2dp = std::dynamic_pointer_cast<BtA2dp>(a2dpDev);
+    for (retry = 0; retry < A2DP_RECONFIG_RETRY_COUNT; retry++) {
+        if (btA2dp && !btA2dp->waitDeviceReady(A2DP_RECONFIG_READY_TIMEOUT_MS)) {
+            PAL_ERR(LOG_TAG, "a2dp not ready after %d ms", A2DP_RECONFIG_READY_TIMEOUT_MS);
+            switchStatus = -ETIMEDOUT;
+            break;
+        }
+        readyMs += a2dpPhaseMs(phaseStart);
+
+        switchStatus = forceDeviceSwitch(a2dpDev, &a2dpDattr);
+        switchMs += a2dpPhaseMs(phaseStart);
+        if (!switchStatus)
+            break;
+        PAL_ERR(LOG_TAG, "a2dp reconfig switch attempt %d failed %d", retry + 1, switchStatus);
+        usleep(A2DP_RECONFIG_RETRY_PERIOD_MS * 1000);
+    }
+    readyMs += a2dpPhaseMs(phaseStart);
 
     mActiveStreamMutex.lock();
     for (sIter = activeA2dpStreams.begin(); sIter != activeA2dpStreams.end(); sIter++) {
@@ -9379,6 +9937,11 @@ int32_t ResourceManager::a2dpReconfig()
         }
     }
     mActiveStreamMutex.unlock();
+    restoreMs = a2dpPhaseMs(phaseStart);
+    PAL_INFO(LOG_TAG, "a2dp reconfig: mute %u drain %u ready %u switch %u restore %u ms",
+             muteMs, drainMs, readyMs, switchMs, restoreMs);
+    if (switchStatus)
+        status = switchStatus;
 
 exit:
     PAL_DBG(LOG_TAG, "exit status: %d", status);
@@ -9880,7 +10443,6 @@ exit:
 int32_t ResourceManager::a2dpSuspend(pal_device_id_t dev_id)
 {
     int status = 0;
-    uint32_t latencyMs = 0, maxLatencyMs = 0;
     std::shared_ptr<Device> a2dpDev = nullptr;
     struct pal_device a2dpDattr;
     struct pal_device switchDevDattr;
@@ -9892,8 +10454,12 @@ int32_t ResourceManager::a2dpSuspend(pal_device_id_t dev_id)
     std::vector <Stream *> activeStreams;
     std::vector <Stream*>::iterator sIter;
     std::vector <std::shared_ptr<Device>> associatedDevices;
+    std::vector <struct muted_drain_entry> drainStreams;
+    std::chrono::steady_clock::time_point phaseStart;
+    uint32_t muteMs = 0, drainMs = 0, switchMs = 0, restoreMs = 0;
 
     PAL_DBG(LOG_TAG, "enter");
+    phaseStart = std::chrono::steady_clock::now();
 
     a2dpDattr.id = dev_id;
     a2dpDev = Device::getInstance(&a2dpDattr, rm);
@@ -10007,12 +10573,10 @@ int32_t ResourceManager::a2dpSuspend(pal_device_id_t dev_id)
                             (*sIter)->a2dpPaused = true;
                     }
                 } else {
-                    latencyMs = (*sIter)->getLatency();
-                    if (maxLatencyMs < latencyMs)
-                        maxLatencyMs = latencyMs;
                     // Mute
                     if (!(*sIter)->mute_l(true))
                         (*sIter)->a2dpMuted = true;
+                    addMutedDrain_l(*sIter, drainStreams);
                 }
             }
             (*sIter)->unlockStreamMutex();
@@ -10020,16 +10584,14 @@ int32_t ResourceManager::a2dpSuspend(pal_device_id_t dev_id)
     }
 
     mActiveStreamMutex.unlock();
+    muteMs = a2dpPhaseMs(phaseStart);
 
     // wait for stale pcm drained before switching to speaker
-    if (maxLatencyMs > 0) {
-        // multiplication factor applied to latency when calculating a safe mute delay
-        // TODO: It's not needed if latency is accurate.
-        const int latencyMuteFactor = 2;
-        usleep(maxLatencyMs * 1000 * latencyMuteFactor);
-    }
+    waitMutedDrain(drainStreams);
+    drainMs = a2dpPhaseMs(phaseStart);
 
     forceDeviceSwitch(a2dpDev, &switchDevDattr, activeA2dpStreams);
+    switchMs = a2dpPhaseMs(phaseStart);
 
     mActiveStreamMutex.lock();
     for (sIter = activeA2dpStreams.begin(); sIter != activeA2dpStreams.end(); sIter++) {
@@ -10052,6 +10614,9 @@ int32_t ResourceManager::a2dpSuspend(pal_device_id_t dev_id)
         }
     }
     mActiveStreamMutex.unlock();
+    restoreMs = a2dpPhaseMs(phaseStart);
+    PAL_INFO(LOG_TAG, "a2dp suspend to device %d: mute %u drain %u switch %u restore %u ms",
+             switchDevDattr.id, muteMs, drainMs, switchMs, restoreMs);
 
 exit:
     PAL_DBG(LOG_TAG, "exit status: %d", status);
@@ -10623,6 +11188,62 @@ int ResourceManager::getParameter(uint32_t param_id, void **param_payload,
             *payload_size = sizeof(pal_param_latency_mode_t);
         }
         break;
+        case PAL_PARAM_ID_THREAD_POLICY:
+        {
+            std::vector<pal_thread_policy_info_t> info;
+            pal_thread_policy_info_t *threads = nullptr;
+
+            ThreadPolicy::getInstance()->query(info);
+            *payload_size = 0;
+            if (info.empty())
+                break;
+
+            threads = (pal_thread_policy_info_t *)calloc(info.size(), sizeof(*threads));
+            if (!threads) {
+                status = -ENOMEM;
+                goto exit;
+            }
+            memcpy(threads, info.data(), info.size() * sizeof(*threads));
+            *param_payload = threads;
+            *payload_size = info.size() * sizeof(*threads);
+            break;
+        }
+        case PAL_PARAM_ID_POWER_VOTE_STATS:
+        {
+            std::vector<PowerVote *> votes;
+            pal_power_vote_stats_t *out = nullptr;
+            struct power_vote_stats stats;
+
+            if (wakeLockVote)
+                votes.push_back(wakeLockVote);
+#ifdef ADSP_SLEEP_MONITOR
+            if (lpiVote_)
+                votes.push_back(lpiVote_);
+            if (nlpiVote_)
+                votes.push_back(nlpiVote_);
+#endif
+            *payload_size = 0;
+            if (votes.empty())
+                break;
+
+            out = (pal_power_vote_stats_t *)calloc(votes.size(), sizeof(*out));
+            if (!out) {
+                status = -ENOMEM;
+                goto exit;
+            }
+            for (size_t i = 0; i < votes.size(); i++) {
+                votes[i]->getStats(&stats);
+                strlcpy(out[i].name, votes[i]->name(), sizeof(out[i].name));
+                out[i].count = votes[i]->getCount();
+                out[i].votes = stats.votes;
+                out[i].unvotes = stats.unvotes;
+                out[i].applied = stats.applied;
+                out[i].absorbed = stats.absorbed;
+            }
+            *param_payload = out;
+            *payload_size = votes.size() * sizeof(*out);
+            break;
+        }
         case PAL_PARAM_ID_PROXY_RECORD_SESSION:
         {
             PAL_VERBOSE(LOG_TAG, "get parameter for Proxy Record session");
@@ -10893,6 +11514,12 @@ int ResourceManager::setParameter(uint32_t param_id, void *param_payload,
                 status = -EINVAL;
                 goto exit;
             }
+            /* charger removed before the deferred insertion handling ran */
+            if (TimerScheduler::getInstance()->cancel(chargerInsertionTimer.exchange(0)) &&
+                !charger_state->is_charger_online) {
+                PAL_DBG(LOG_TAG, "pending charger insertion dropped");
+                goto exit;
+            }
             if (is_charger_online_ != charger_state->is_charger_online) {
                 dattr.id = PAL_DEVICE_OUT_SPEAKER;
                 is_charger_online_ = charger_state->is_charger_online;
@@ -11136,8 +11763,6 @@ int ResourceManager::setParameter(uint32_t param_id, void *param_payload,
             struct pal_device dattr;
             pal_param_bta2dp_t *current_param_bt_a2dp = nullptr;
             pal_param_bta2dp_t param_bt_a2dp;
-            int retrycnt = 20;
-            const int retryPeriodMs = 100;
 
             if (isDeviceAvailable(PAL_DEVICE_OUT_BLUETOOTH_A2DP)) {
                 dattr.id = PAL_DEVICE_OUT_BLUETOOTH_A2DP;
@@ -11167,20 +11792,8 @@ int ResourceManager::setParameter(uint32_t param_id, void *param_payload,
                 if ((current_param_bt_a2dp->reconfig == true) &&
                     (current_param_bt_a2dp->a2dp_suspended == false)) {
                     mResourceManagerMutex.unlock();
+                    /* waits for the BT stack to be ready before switching back */
                     status = a2dpReconfig();
-
-                    /* During reconfig stage, if a2dp is not in a ready state streamdevswitch
-                     * to BT will be failed. Reiterate the a2dpreconfig until it
-                     * succeeds with sleep period of 100 msecs and retry count = 20.
-                     */
-                    while ((status != 0) && (retrycnt > 0)) {
-                        if (isDeviceReady(PAL_DEVICE_OUT_BLUETOOTH_A2DP)) {
-                            status = a2dpReconfig();
-                        }
-                        usleep(retryPeriodMs * 1000);
-                        retrycnt--;
-                    }
-
                     mResourceManagerMutex.lock();
 
                     param_bt_a2dp.reconfig = false;
@@ -12197,6 +12810,8 @@ int ResourceManager::handleDeviceConnectionChange(pal_param_device_connection_t
     }
 
     PAL_DBG(LOG_TAG, "Enter");
+    if (!is_connected)
+        WarmStreamPool::invalidate();
     memset(&conn_device, 0, sizeof(struct pal_device));
     if (is_connected && !device_available) {
         if (isPluginDevice(device_id) || isDpDevice(device_id)) {
@@ -13383,11 +13998,8 @@ void ResourceManager::process_device_info(struct xml_userdata *data, const XML_C
         if (!strcmp(tag_name, "id")) {
             std::string rxDeviceName(data->data_buf);
             pal_device_id_t rxDeviceId  = deviceIdLUT.at(rxDeviceName);
-            std::vector<std::pair<Stream *, int>> str_list;
-            str_list.clear();
             size = deviceInfo.size() - 1;
             deviceInfo[size].rx_dev_ids.push_back(rxDeviceId);
-            deviceInfo[size].ec_ref_count_map.insert({rxDeviceId, str_list});
         }
     } else if (data->tag == TAG_VI_CHMAP) {
         if (!strcmp(tag_name, "channel")) {
@@ -13668,6 +14280,9 @@ void ResourceManager::startTag(void *userdata, const XML_Char *tag_name,
     } else if(strcmp(tag_name, "temp_ctrl") == 0) {
         processSpkrTempCtrls(attr);
         return;
+    } else if (!strcmp(tag_name, "thread_policy")) {
+        ThreadPolicy::getInstance()->configure(attr);
+        return;
     } else if (!strcmp(tag_name, "usb_vendor")) {
         if (attr[1])
             usb_vendor_uuid_list.push_back(attr[1]);
@@ -14308,13 +14923,10 @@ int ResourceManager::setUltrasoundGain(pal_ultrasound_gain_t gain, Stream *s)
 {
     int32_t status = 0;
 
-    struct pal_device dAttr;
     StreamUltraSound *updStream = NULL;
     std::vector<Stream*> activeStreams;
     struct pal_stream_attributes sAttr;
     struct pal_stream_attributes sAttr1;
-    std::vector<std::shared_ptr<Device>> activeDeviceList;
-    pal_ultrasound_gain_t gain_2 = PAL_ULTRASOUND_GAIN_MUTE;
 
     PAL_INFO(LOG_TAG, "Entered. Gain = %d", gain);
 
@@ -14389,11 +15001,57 @@ int ResourceManager::setUltrasoundGain(pal_ultrasound_gain_t gain, Stream *s)
      */
 
     if ((PAL_ULTRASOUND_GAIN_MUTE != gain) || isDeviceSwitch) {
+        /* an explicit gain supersedes a pending follow-up */
+        TimerScheduler::getInstance()->cancel(updGainTimer);
         return 0;
     }
 
+    /*
+     * Currently configured value is 20ms which allows 3 to 4 process call
+     * to handle the mute at ADSP side before the new gain is picked.
+     * Done from the timer thread so mResourceManagerMutex is not held
+     * across the wait.
+     */
+    TimerScheduler::getInstance()->reschedule(&updGainTimer, UPD_GAIN_SETTLE_MS,
+                                              onUltrasoundGainTimeout, this);
+
+    return status;
+}
+
+void ResourceManager::onUltrasoundGainTimeout(void *cookie)
+{
+    ResourceManager *rm = (ResourceManager *)cookie;
+    int32_t status = 0;
+    struct pal_device dAttr;
+    struct pal_stream_attributes sAttr;
+    StreamUltraSound *updStream = NULL;
+    std::vector<Stream*> activeStreams;
+    std::vector<std::shared_ptr<Device>> activeDeviceList;
+    pal_ultrasound_gain_t gain = PAL_ULTRASOUND_GAIN_MUTE;
+
+    /* the active stream lock keeps the UPD stream from being closed under us */
+    rm->lockActiveStream();
+    mResourceManagerMutex.lock();
+    if (rm->isDeviceSwitch) {
+        PAL_DBG(LOG_TAG, "device switch in progress, gain set once new device is active");
+        goto unlock;
+    }
+
+    status = rm->getActiveStream_l(activeStreams, NULL);
+    for (int i = 0; status == 0 && i < activeStreams.size(); i++) {
+        if (activeStreams[i]->getStreamAttributes(&sAttr) == 0 &&
+            PAL_STREAM_ULTRASOUND == sAttr.type) {
+            updStream = static_cast<StreamUltraSound *> (activeStreams[i]);
+            break;
+        }
+    }
+    if (!updStream || !updStream->isActive()) {
+        PAL_DBG(LOG_TAG, "UPD stream gone or inactive, skip gain update");
+        goto unlock;
+    }
+
     /* Find new GAIN value based on currently active devices */
-    getActiveDevices_l(activeDeviceList);
+    rm->getActiveDevices_l(activeDeviceList);
     for (int i = 0; i < activeDeviceList.size(); i++) {
         status = activeDeviceList[i]->getDeviceAttributes(&dAttr);
         if (0 != status) {
@@ -14402,34 +15060,30 @@ int ResourceManager::setUltrasoundGain(pal_ultrasound_gain_t gain, Stream *s)
             continue;
         }
         if (PAL_DEVICE_OUT_SPEAKER == dAttr.id) {
-            gain_2 = PAL_ULTRASOUND_GAIN_HIGH;
+            gain = PAL_ULTRASOUND_GAIN_HIGH;
             /* Only breaking here as we want to give priority to speaker device */
             break;
         } else if ((PAL_DEVICE_OUT_ULTRASOUND == dAttr.id) ||
                 (PAL_DEVICE_OUT_ULTRASOUND_DEDICATED == dAttr.id) ||
                 (PAL_DEVICE_OUT_HANDSET == dAttr.id)) {
-            gain_2 = PAL_ULTRASOUND_GAIN_LOW;
+            gain = PAL_ULTRASOUND_GAIN_LOW;
         }
     }
+    mResourceManagerMutex.unlock();
 
-    if (PAL_ULTRASOUND_GAIN_MUTE != gain_2) {
-        /* Currently configured value is 20ms which allows 3 to 4 process call
-         * to handle this value at ADSP side.
-         * Increase or decrease this dealy based on requirements */
-        usleep(20000);
-        if (PAL_STREAM_ULTRASOUND != sAttr.type)
-            status = updStream->setUltraSoundGain(gain_2);
-        else
-            status = updStream->setUltraSoundGain_l(gain_2);
-
-        if (0 != status) {
+    if (PAL_ULTRASOUND_GAIN_MUTE != gain) {
+        status = updStream->setUltraSoundGain(gain);
+        if (0 != status)
             PAL_ERR(LOG_TAG, "SetParameters failed, status = %d", status);
-            return status;
-        }
-        PAL_INFO(LOG_TAG, "Ultrasound gain(%d) set, status = %d", gain_2, status);
+        else
+            PAL_INFO(LOG_TAG, "Ultrasound gain(%d) set", gain);
     }
+    rm->unlockActiveStream();
+    return;
 
-    return status;
+unlock:
+    mResourceManagerMutex.unlock();
+    rm->unlockActiveStream();
 }
 
 void ResourceManager::WbSpeechConfig(pal_device_id_t devId,
@@ -52,6 +52,8 @@ static int exit_thread = 0; //by default exit thread is made false
 
 void SndCardMonitor::monitorThreadLoop()
 {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_BACKGROUND, "pal_card_mon");
+
     struct pollfd *poll_fds;
     int rv = 0;
     char buf[12];
@@ -46,6 +46,16 @@
 class Session;
 class Stream;
 
+/* Bounds for the preallocated detection event ring and notification table */
+#define ACD_MAX_EVENT_CONTEXTS 32
+#define ACD_EVENT_SLOT_COUNT 16
+#define ACD_MAX_NOTIFY_ENTRIES 64
+
+struct acd_notify_entry {
+    Stream *s;
+    struct acd_per_context_event_info info;
+};
+
 /* This is used to maintain list of streams with threshold info per context */
 struct stream_context_info {
     uint32_t threshold;
@@ -79,7 +89,11 @@ private:
     int32_t PopulateSoundModel(std::string model_file_name, uint32_t model_uuid);
     int32_t PopulateEventPayload();
     void ParseEventAndNotifyClient();
+    void ParseEvent(uint8_t *event_data, uint32_t size, uint64_t *detection_ts);
+    void NotifyClients(uint64_t detection_ts);
     void HandleSessionEvent(uint32_t event_id __unused, void *data, uint32_t size);
+    bool CoalesceEvents(uint32_t old_slot, uint32_t new_slot);
+    bool CoalescePendingEvents();
     bool AreOtherStreamsAttached(Stream *s);
     void UpdateModelCount(struct pal_param_context_list *context_cfg, bool enable);
     void AddEventInfoForStream(Stream *s, struct acd_recognition_cfg *recog_cfg);
@@ -93,7 +107,21 @@ private:
     bool IsEngineActive();
 
     static std::shared_ptr<ACDEngine> eng_;
-    std::queue<void *> eventQ;
+    /*
+     * Ring of fixed size event slots filled by the session callback and
+     * parsed in place by the event thread, guarded by mutex_.
+     */
+    std::vector<uint8_t> event_slots_;
+    size_t event_slot_size_;
+    uint32_t event_slot_len_[ACD_EVENT_SLOT_COUNT];
+    uint32_t event_head_;
+    uint32_t event_count_;
+    /* signalled when the event thread frees ring slots */
+    std::condition_variable space_cv_;
+    /* per-stream notifications built by the event thread only */
+    struct acd_notify_entry notify_entries_[ACD_MAX_NOTIFY_ENTRIES];
+    uint32_t num_notify_entries_;
+    std::vector<uint8_t> notify_buf_;
     /* contextinfo_stream_map_ maps context_id with map of stream*
      * and associated threshold values.
      * e.g.
@@ -43,6 +43,8 @@
 #include <string.h>
 #include <stdlib.h>
 #include <memory>
+#include <map>
+#include <thread>
 #include <errno.h>
 #include "PalCommon.h"
 #include "Device.h"
@@ -125,6 +127,16 @@ protected:
     bool frontEndIdAllocated = false;
     struct pal_param_haptics_cnfg_t *hpCnfg;
     void setInitialVolume();
+    /* setParam that joins the open batch of the calling thread, if any */
+    int setMixerParam(int device, void *payload, size_t size);
+    std::mutex paramBatchMutex;
+    std::thread::id paramBatchOwner;
+    bool paramBatchActive = false;
+    int paramBatchDevice = -1;
+    std::vector<uint8_t> paramBatch;
+    /* {tag, FE device or -1} -> {miid, device} resolved while the batch is open */
+    std::map<std::pair<uint32_t, int>, std::pair<uint32_t, int>> paramBatchMiids;
+    int getModuleInstanceId(int device, const char *intf, uint32_t tagId, uint32_t *miid);
 public:
     bool isMixerEventCbRegd;
     bool isPauseRegistrationDone;
@@ -165,8 +177,17 @@ public:
     virtual int registerCallBack(session_callback cb __unused, uint64_t cookie __unused) {return 0;};
     virtual int drain(pal_drain_type_t type __unused) {return 0;};
     virtual int flush() {return 0;};
+    /* open and configure the graph ahead of start(), which commits it */
+    virtual int prearm(Stream *s __unused) {return -ENOSYS;};
+    virtual int disarm(Stream *s __unused) {return 0;};
     virtual void setEventPayload(uint32_t event_id __unused, void *payload __unused, size_t payload_size __unused) {  };
     virtual int getTimestamp(struct pal_session_time *stime __unused) {return 0;};
+    /* sessions without a timestamp cache report every reading as fresh */
+    virtual int getTimestampInfo(pal_timestamp_info_t *info, bool fresh __unused = false)
+    {
+        memset(info, 0, sizeof(*info));
+        return getTimestamp(&info->stime);
+    };
     /*TODO need to implement connect/disconnect in basecase*/
     virtual int setupSessionDevice(Stream* streamHandle, pal_stream_type_t streamType,
         std::shared_ptr<Device> deviceToCconnect) = 0;
@@ -174,6 +195,11 @@ public:
         std::shared_ptr<Device> deviceToCconnect) = 0;
     virtual int disconnectSessionDevice(Stream* streamHandle, pal_stream_type_t streamType,
         std::shared_ptr<Device> deviceToDisconnect) = 0;
+    /* undo setupSessionDevice for a device that never got connected */
+    virtual int releaseSessionDevice(Stream* streamHandle __unused,
+        pal_stream_type_t streamType __unused,
+        std::shared_ptr<Device> deviceToRelease __unused,
+        std::shared_ptr<Device> deviceInUse __unused) { return 0; }
     virtual int setECRef(Stream *s, std::shared_ptr<Device> rx_dev, bool is_enable) = 0;
     void getSamplerateChannelBitwidthTags(struct pal_media_config *config,
         uint32_t &sr_tag, uint32_t &ch_tag, uint32_t &bitwidth_tag);
@@ -181,6 +207,12 @@ public:
     virtual uint32_t getMIID(const char *backendName __unused, uint32_t tagId __unused, uint32_t *miid __unused) { return -EINVAL; }
     int getEffectParameters(Stream *s, effect_pal_payload_t *effectPayload);
     int setEffectParameters(Stream *s, effect_pal_payload_t *effectPayload);
+    /*
+     * Between begin and end, setParam payloads issued by this thread are
+     * concatenated and sent with a single ioctl by endParamBatch().
+     */
+    void beginParamBatch();
+    int endParamBatch();
     int rwACDBParameters(void *payload, uint32_t sampleRate, bool isParamWrite);
     int rwACDBParamTunnel(void *payload, pal_device_id_t palDeviceId,
         pal_stream_type_t palStreamType, uint32_t sampleRate, uint32_t instanceId,
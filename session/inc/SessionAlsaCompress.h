@@ -49,6 +49,8 @@
 #include <condition_variable>
 #include <sound/compress_params.h>
 #include <tinycompress/tinycompress.h>
+#include "OffloadWorkerPool.h"
+#include "TimestampCache.h"
 
 #define EARLY_EOS_DELAY_MS 150
 
@@ -56,7 +58,6 @@ class Stream;
 class Session;
 
 enum {
-    OFFLOAD_CMD_EXIT,               /* exit compress offload thread loop*/
     OFFLOAD_CMD_DRAIN,              /* send a full drain request to DSP */
     OFFLOAD_CMD_PARTIAL_DRAIN,      /* send a partial drain request to DSP */
     OFFLOAD_CMD_WAIT_FOR_BUFFER,    /* wait for buffer released by DSP */
@@ -81,29 +82,23 @@ enum {
 #define PAL_SND_PROFILE_WMA10_LOSSLESS SND_AUDIOMODE_WMAPRO_LEVELM2
 #endif
 
-struct offload_msg {
-    offload_msg(int c)
-        :cmd(c) {}
-    int cmd; /**< command */
-};
-
 class SessionAlsaCompress : public Session
 {
 private:
 
     struct compress *compress;
     uint32_t spr_miid = 0;
+    TimestampCache tsCache;
     PayloadBuilder* builder;
     struct snd_codec codec;
     //  unsigned int compressDevId;
     std::vector<int> compressDevIds;
-    std::unique_ptr<std::thread> worker_thread;
-    std::queue<std::shared_ptr<offload_msg>> msg_queue_;
+    struct offload_task offloadTask; /* slot in the shared offload worker pool */
+    bool isDrainCalled = false;
+    int offloadRet = 0; /* last compress ioctl result seen by the offload handler */
     size_t compress_cap_buf_size;
     std::vector<std::pair<std::string, int>> freeDeviceMetadata;
 
-    std::condition_variable cv_; /* used to wait for incoming requests */
-    std::mutex cv_mutex_; /* mutex used in conjunction with above cv */
     void getSndCodecParam(struct snd_codec &codec, struct pal_stream_attributes &sAttr);
     int getSndCodecId(pal_audio_fmt_t fmt);
     int setCustomFormatParam(pal_audio_fmt_t audio_fmt);
@@ -148,11 +143,12 @@ public:
     int read(Stream *s, int tag, struct pal_buffer *buf, int * size) override;
     int write(Stream *s, int tag, struct pal_buffer *buf, int * size, int flag) override;
     int setECRef(Stream *s, std::shared_ptr<Device> rx_dev, bool is_enable) override;
-    static void offloadThreadLoop(SessionAlsaCompress *ob);
+    static void offloadCmdHandler(void *cookie, int cmd);
     int registerCallBack(session_callback cb, uint64_t cookie);
     int drain(pal_drain_type_t type);
     int flush();
     int getTimestamp(struct pal_session_time *stime) override;
+    int getTimestampInfo(pal_timestamp_info_t *info, bool fresh = false) override;
     int setupSessionDevice(Stream* streamHandle, pal_stream_type_t streamType,
         std::shared_ptr<Device> deviceToConnect) override;
     int connectSessionDevice(Stream* streamHandle, pal_stream_type_t streamType,
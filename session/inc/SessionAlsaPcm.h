@@ -69,6 +69,7 @@
 #include "Session.h"
 #include "PalAudioRoute.h"
 #include "PalCommon.h"
+#include "TimestampCache.h"
 #include <tinyalsa/asoundlib.h>
 #include <thread>
 #include <mutex>
@@ -83,6 +84,7 @@ class SessionAlsaPcm : public Session
 {
 private:
     uint32_t spr_miid = 0;
+    TimestampCache tsCache;
     PayloadBuilder* builder;
     struct pcm *pcm;
     struct pcm *pcmRx;
@@ -127,6 +129,7 @@ public:
     int getParameters(Stream *s, int tagId, uint32_t param_id, void **payload) override;
     int setECRef(Stream *s, std::shared_ptr<Device> rx_dev, bool is_enable) override;
     int getTimestamp(struct pal_session_time *stime) override;
+    int getTimestampInfo(pal_timestamp_info_t *info, bool fresh = false) override;
     int registerCallBack(session_callback cb, uint64_t cookie) override;
     int drain(pal_drain_type_t type) override;
     int flush();
@@ -118,7 +118,6 @@ public:
     static int registerMixerEvent(struct mixer *mixer, int device, void *payload, int payload_size);
     static int setECRefPath(struct mixer *mixer, int device, const char *intf_name);
 
-    static int getTimestamp(struct mixer *mixer, const std::vector<int> &DevIds, uint32_t spr_miid, struct pal_session_time *stime);
     static int disconnectSessionDevice(Stream* streamHandle, pal_stream_type_t streamType,
         std::shared_ptr<ResourceManager> rm, struct pal_device &dAttr,
         const std::vector<int> &pcmDevIds,
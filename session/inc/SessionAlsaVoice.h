@@ -99,6 +99,7 @@ private:
     bool hd_voice = false;
     pal_device_mute_t dev_mute = {};
     int sideTone_cnt = 0;
+    bool prearmed = false;
 
 public:
 
@@ -114,11 +115,17 @@ public:
     int start(Stream * s) override;
     int stop(Stream * s) override;
     int close(Stream * s) override;
+    int prearm(Stream * s) override;
+    int disarm(Stream * s) override;
     int setupSessionDevice(Stream* streamHandle, pal_stream_type_t streamType,
         std::shared_ptr<Device> deviceToConnect) override;
     int disconnectSessionDevice(Stream *streamHandle,
                                 pal_stream_type_t streamType,
                                 std::shared_ptr<Device> deviceToDisconnect);
+    int releaseSessionDevice(Stream *streamHandle,
+                             pal_stream_type_t streamType,
+                             std::shared_ptr<Device> deviceToRelease,
+                             std::shared_ptr<Device> deviceInUse) override;
     int connectSessionDevice(Stream* streamHandle,
                              pal_stream_type_t streamType,
                              std::shared_ptr<Device> deviceToConnect);
@@ -150,6 +157,7 @@ private:
     int setExtECRef(Stream *s, std::shared_ptr<Device> rx_dev, bool is_enable);
     int getRXDevice(Stream *s, std::shared_ptr<Device> &rx_dev);
     int getDeviceData(Stream *s, struct sessionToPayloadParam *deviceData);
+    int stageGraph(Stream * s, std::shared_ptr<Device> rxDevice);
 };
 
 #endif //SESSION_ALSAVOICE_H
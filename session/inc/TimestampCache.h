@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef TIMESTAMP_CACHE_H
+#define TIMESTAMP_CACHE_H
+
+#include "PalDefs.h"
+#include <tinyalsa/asoundlib.h>
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+/* minimum spacing of SPR session time queries sent to the DSP */
+#define PAL_TIMESTAMP_QUERY_INTERVAL_US 20000
+
+/*
+ * Per session cache of the SPR session time. The getParam control and the
+ * request/response buffers are resolved once; between DSP queries the last
+ * reading is extrapolated with CLOCK_MONOTONIC while the session is seen to
+ * advance. SPR reports microseconds, so no sample rate scaling is needed.
+ */
+class TimestampCache {
+public:
+    TimestampCache();
+
+    /* drop the cached reading, call on start/stop/pause/resume/flush */
+    void invalidate();
+    /* fresh: query the DSP now and return its raw reading */
+    int getTimestamp(struct mixer *mixer, int devId, uint32_t sprMiid,
+                     pal_timestamp_info_t *info, bool fresh = false);
+
+protected:
+    int setup_l(struct mixer *mixer, int devId, uint32_t sprMiid);
+    int query_l(struct pal_session_time *stime);
+    static uint64_t nowUs();
+    static uint64_t toUs(const struct pal_time_us &t);
+    static void fromUs(uint64_t us, struct pal_time_us *t);
+
+    std::mutex mutex_;
+    struct mixer *mixer_;
+    struct mixer_ctl *ctl_;
+    int devId_;
+    uint32_t sprMiid_;
+    std::vector<uint8_t> request_;
+    std::vector<uint8_t> response_;
+    struct pal_session_time last_;
+    uint64_t lastQueryUs_;
+    uint64_t lastReturnedUs_;
+    bool valid_;
+    bool advancing_;
+};
+
+#endif /* TIMESTAMP_CACHE_H */
@@ -88,6 +88,18 @@ ACDEngine::ACDEngine(Stream *s, std::shared_ptr<ACDStreamConfig> sm_cfg) :
 
     PAL_DBG(LOG_TAG, "Enter");
 
+    event_slot_size_ = sizeof(struct event_id_acd_detection_event_t) +
+                       sizeof(struct acd_key_info_t) +
+                       sizeof(struct acd_generic_key_id_reg_cfg_t) +
+                       ACD_MAX_EVENT_CONTEXTS * sizeof(struct acd_per_context_event_info);
+    event_slots_.resize(event_slot_size_ * ACD_EVENT_SLOT_COUNT);
+    memset(event_slot_len_, 0, sizeof(event_slot_len_));
+    event_head_ = 0;
+    event_count_ = 0;
+    num_notify_entries_ = 0;
+    notify_buf_.resize(sizeof(struct acd_context_event) +
+                       ACD_MAX_NOTIFY_ENTRIES * sizeof(struct acd_per_context_event_info));
+
     session_->registerCallBack(HandleSessionCallBack, (uint64_t)this);
 
     PAL_DBG(LOG_TAG, "Exit");
@@ -198,149 +210,167 @@ exit:
     return status;
 }
 
-void ACDEngine::ParseEventAndNotifyClient()
+void ACDEngine::ParseEvent(uint8_t *event_data, uint32_t size, uint64_t *detection_ts)
 {
-    uint8_t *event_data;
-    uint8_t *opaque_ptr;
-    uint64_t detection_ts = 0;
-    int i;
-    struct acd_context_event *event = NULL;
+    uint8_t *opaque_ptr = event_data;
+    struct acd_key_info_t *key_info = NULL;
+    struct acd_generic_key_id_reg_cfg_t *reg_cfg = NULL;
+    struct event_id_acd_detection_event_t *detection_event = NULL;
     struct acd_per_context_event_info *event_info = NULL;
-    int num_contexts = 0;
-    std::map<Stream *, std::vector<struct acd_per_context_event_info *>*> stream_event_info;
-
-    /* ParseEvent */
-    while (!eventQ.empty())
-    {
-        struct acd_key_info_t *key_info = NULL;
-        struct acd_generic_key_id_reg_cfg_t *reg_cfg = NULL;
-        struct event_id_acd_detection_event_t *detection_event = NULL;
-        int i;
-
-        event_data = (uint8_t *)eventQ.front();
-        eventQ.pop();
-        opaque_ptr = event_data;
-        detection_event = (struct event_id_acd_detection_event_t *)opaque_ptr;
-        detection_ts = ((detection_event->event_timestamp_msw << 8) |
-                        detection_event->event_timestamp_lsw);
-        opaque_ptr += sizeof(struct event_id_acd_detection_event_t);
-        key_info = (struct acd_key_info_t *)opaque_ptr;
-        PAL_INFO(LOG_TAG, "key id: %d", key_info->key_id);
-
-        opaque_ptr += sizeof(struct acd_key_info_t);
-        reg_cfg = (struct acd_generic_key_id_reg_cfg_t *)opaque_ptr;
-        PAL_INFO(LOG_TAG, "Num contexts: %d", reg_cfg->num_contexts);
-
-        opaque_ptr += sizeof(struct acd_generic_key_id_reg_cfg_t);
-        for (i = 0; i < reg_cfg->num_contexts; i++) {
-            uint32_t context_id;
-            uint32_t event_type;
-            std::map<Stream *, struct stream_context_info *> *stream_ctx_data;
-
-            event_info = (struct acd_per_context_event_info *)opaque_ptr;
-            opaque_ptr += sizeof(struct acd_per_context_event_info);
-            context_id = event_info->context_id;
-            event_type = event_info->event_type;
-
-            PAL_INFO(LOG_TAG, "Context Detection event %d received", event_type);
-
-            auto iter = contextinfo_stream_map_.find(context_id);
-            if (iter != contextinfo_stream_map_.end()) {
-                stream_ctx_data = iter->second;
-
-                PAL_INFO(LOG_TAG, "Received event contextId 0x%x, confidenceScore %d",
-                            context_id, event_info->confidence_score);
-
-                for (auto iter2 = stream_ctx_data->begin();
-                     iter2 != stream_ctx_data->end(); ++iter2) {
-                    bool notify_stream = false;
-                    struct stream_context_info *context_cfg = iter2->second;
-                    StreamACD *s = dynamic_cast<StreamACD *>(iter2->first);
-
-                    PAL_VERBOSE(LOG_TAG, "Stream Threshold value for contextid[%d] is %d",
-                                context_id, context_cfg->threshold);
-
-                    if ((event_type == AUDIO_CONTEXT_EVENT_STOPPED) &&
-                         (context_cfg->last_event_type != AUDIO_CONTEXT_EVENT_STOPPED)) {
-                        notify_stream = true;
-                    } else if ((event_type == AUDIO_CONTEXT_EVENT_STARTED) &&
-                               (event_info->confidence_score >= context_cfg->threshold)) {
+    size_t hdr_size = sizeof(struct event_id_acd_detection_event_t) +
+                      sizeof(struct acd_key_info_t) +
+                      sizeof(struct acd_generic_key_id_reg_cfg_t);
+    uint32_t num_contexts;
+    uint32_t i;
+
+    if (size < hdr_size) {
+        PAL_ERR(LOG_TAG, "Error:%d Invalid event size %u", -EINVAL, size);
+        return;
+    }
+
+    detection_event = (struct event_id_acd_detection_event_t *)opaque_ptr;
+    *detection_ts = ((detection_event->event_timestamp_msw << 8) |
+                    detection_event->event_timestamp_lsw);
+    opaque_ptr += sizeof(struct event_id_acd_detection_event_t);
+    key_info = (struct acd_key_info_t *)opaque_ptr;
+    PAL_INFO(LOG_TAG, "key id: %d", key_info->key_id);
+
+    opaque_ptr += sizeof(struct acd_key_info_t);
+    reg_cfg = (struct acd_generic_key_id_reg_cfg_t *)opaque_ptr;
+    PAL_INFO(LOG_TAG, "Num contexts: %d", reg_cfg->num_contexts);
+
+    num_contexts = reg_cfg->num_contexts;
+    if (num_contexts > (size - hdr_size) / sizeof(struct acd_per_context_event_info)) {
+        PAL_ERR(LOG_TAG, "Error:%d event carries %u contexts, truncated",
+                -EINVAL, num_contexts);
+        num_contexts = (size - hdr_size) / sizeof(struct acd_per_context_event_info);
+    }
+
+    opaque_ptr += sizeof(struct acd_generic_key_id_reg_cfg_t);
+    for (i = 0; i < num_contexts; i++) {
+        uint32_t context_id;
+        uint32_t event_type;
+        std::map<Stream *, struct stream_context_info *> *stream_ctx_data;
+
+        event_info = (struct acd_per_context_event_info *)opaque_ptr;
+        opaque_ptr += sizeof(struct acd_per_context_event_info);
+        context_id = event_info->context_id;
+        event_type = event_info->event_type;
+
+        PAL_INFO(LOG_TAG, "Context Detection event %d received", event_type);
+
+        auto iter = contextinfo_stream_map_.find(context_id);
+        if (iter != contextinfo_stream_map_.end()) {
+            stream_ctx_data = iter->second;
+
+            PAL_INFO(LOG_TAG, "Received event contextId 0x%x, confidenceScore %d",
+                        context_id, event_info->confidence_score);
+
+            for (auto iter2 = stream_ctx_data->begin();
+                 iter2 != stream_ctx_data->end(); ++iter2) {
+                bool notify_stream = false;
+                struct stream_context_info *context_cfg = iter2->second;
+                StreamACD *s = dynamic_cast<StreamACD *>(iter2->first);
+
+                PAL_VERBOSE(LOG_TAG, "Stream Threshold value for contextid[%d] is %d",
+                            context_id, context_cfg->threshold);
+
+                if ((event_type == AUDIO_CONTEXT_EVENT_STOPPED) &&
+                     (context_cfg->last_event_type != AUDIO_CONTEXT_EVENT_STOPPED)) {
+                    notify_stream = true;
+                } else if ((event_type == AUDIO_CONTEXT_EVENT_STARTED) &&
+                           (event_info->confidence_score >= context_cfg->threshold)) {
+                    notify_stream = true;
+                } else if (event_type == AUDIO_CONTEXT_EVENT_DETECTED) {
+                    if (context_cfg->last_event_type == AUDIO_CONTEXT_EVENT_STARTED) {
                         notify_stream = true;
-                    } else if (event_type == AUDIO_CONTEXT_EVENT_DETECTED) {
-                        if (context_cfg->last_event_type == AUDIO_CONTEXT_EVENT_STARTED) {
+                    } else if (context_cfg->last_event_type == AUDIO_CONTEXT_EVENT_STOPPED) {
+                        if (event_info->confidence_score >= context_cfg->threshold) {
+                            PAL_INFO(LOG_TAG, "Changing event type to Started");
+                            event_type = AUDIO_CONTEXT_EVENT_STARTED;
                             notify_stream = true;
-                        } else if (context_cfg->last_event_type == AUDIO_CONTEXT_EVENT_STOPPED) {
-                            if (event_info->confidence_score >= context_cfg->threshold) {
-                                PAL_INFO(LOG_TAG, "Changing event type to Started");
-                                event_type = AUDIO_CONTEXT_EVENT_STARTED;
-                                notify_stream = true;
-                            }
-                        } else if (context_cfg->last_event_type == AUDIO_CONTEXT_EVENT_DETECTED) {
-                            if (abs(double((int)event_info->confidence_score - (int)context_cfg->last_confidence_score)) >= context_cfg->step_size)
-                                notify_stream = true;
                         }
+                    } else if (context_cfg->last_event_type == AUDIO_CONTEXT_EVENT_DETECTED) {
+                        if (abs(double((int)event_info->confidence_score - (int)context_cfg->last_confidence_score)) >= context_cfg->step_size)
+                            notify_stream = true;
                     }
-                    PAL_DBG(LOG_TAG, "last_event_type = %d, last_confidence_score = %d",
-                            context_cfg->last_event_type, context_cfg->last_confidence_score);
-
-                    if (notify_stream) {
-                        std::vector<struct acd_per_context_event_info *> *event_list;
-                        auto iter3 = stream_event_info.find(s);
-                        struct acd_per_context_event_info *stream_event_data =
-                            (struct acd_per_context_event_info *)calloc(1, sizeof(struct acd_per_context_event_info));
-                        if(stream_event_data != NULL){
-                            memcpy(stream_event_data, event_info, sizeof(*event_info));
-                            stream_event_data->event_type = event_type;
-                            context_cfg->last_event_type = event_type;
-                            context_cfg->last_confidence_score = event_info->confidence_score;
-
-                            if (iter3 != stream_event_info.end()) {
-                                event_list = iter3->second;
-                                event_list->push_back(stream_event_data);
-                            } else {
-                                event_list = new(std::vector<struct acd_per_context_event_info *>);
-                                event_list->push_back(stream_event_data);
-                                stream_event_info.insert(std::make_pair(s, event_list));
-                            }
-                        }
+                }
+                PAL_DBG(LOG_TAG, "last_event_type = %d, last_confidence_score = %d",
+                        context_cfg->last_event_type, context_cfg->last_confidence_score);
+
+                if (notify_stream) {
+                    if (num_notify_entries_ >= ACD_MAX_NOTIFY_ENTRIES) {
+                        PAL_ERR(LOG_TAG, "Error:%d notification table full, drop context 0x%x",
+                                -ENOMEM, context_id);
+                        continue;
                     }
+                    struct acd_notify_entry *entry = &notify_entries_[num_notify_entries_++];
+                    entry->s = s;
+                    memcpy(&entry->info, event_info, sizeof(*event_info));
+                    entry->info.event_type = event_type;
+                    context_cfg->last_event_type = event_type;
+                    context_cfg->last_confidence_score = event_info->confidence_score;
                 }
-            } else {
-                PAL_ERR(LOG_TAG, "Error:%d Received unregistered context %d event", -EINVAL, context_id);
             }
+        } else {
+            PAL_ERR(LOG_TAG, "Error:%d Received unregistered context %d event", -EINVAL, context_id);
         }
-        free(event_data);
     }
-    /* NotifyClient */
-    mutex_.unlock();
-    for (auto iter4 = stream_event_info.begin();
-         iter4 != stream_event_info.end();) {
-        StreamACD *s = dynamic_cast<StreamACD *>(iter4->first);
-        std::vector<struct acd_per_context_event_info *> event_list = *(iter4->second);
-
-        num_contexts = event_list.size();
-        event = (struct acd_context_event *)calloc(1, sizeof(*event) + (num_contexts * sizeof(acd_per_context_event_info)));
-        if(event != NULL){
-            event->detection_ts = detection_ts;
-            event->num_contexts = num_contexts;
-            opaque_ptr = (uint8_t *)event + sizeof(*event);
-            for (i = 0; i < num_contexts; i++) {
-                event_info = event_list[i];
-                memcpy(opaque_ptr, event_info, sizeof(*event_info));
-                free(event_info);
-                opaque_ptr += sizeof(*event_info);
-            }
-            s->SetEngineDetectionData(event);
-            delete(iter4->second);
-            stream_event_info.erase(iter4++);
-            free(event);
+}
+
+/*
+ * Emits one acd_context_event per stream from the flat notification
+ * table, reusing notify_buf_. Called without mutex_ held.
+ */
+void ACDEngine::NotifyClients(uint64_t detection_ts)
+{
+    struct acd_context_event *event = (struct acd_context_event *)notify_buf_.data();
+    struct acd_per_context_event_info *event_info = NULL;
+    Stream *s = NULL;
+    uint32_t i, j;
+
+    for (i = 0; i < num_notify_entries_; i++) {
+        s = notify_entries_[i].s;
+        if (!s)
+            continue;
+
+        event->detection_ts = detection_ts;
+        event->num_contexts = 0;
+        event_info = (struct acd_per_context_event_info *)((uint8_t *)event + sizeof(*event));
+        for (j = i; j < num_notify_entries_; j++) {
+            if (notify_entries_[j].s != s)
+                continue;
+            event_info[event->num_contexts++] = notify_entries_[j].info;
+            notify_entries_[j].s = NULL;
         }
+        dynamic_cast<StreamACD *>(s)->SetEngineDetectionData(event);
+    }
+    num_notify_entries_ = 0;
+}
+
+void ACDEngine::ParseEventAndNotifyClient()
+{
+    uint64_t detection_ts = 0;
+
+    /* ParseEvent, in place from the event ring */
+    while (event_count_) {
+        ParseEvent(&event_slots_[event_head_ * event_slot_size_],
+                   event_slot_len_[event_head_], &detection_ts);
+        event_head_ = (event_head_ + 1) % ACD_EVENT_SLOT_COUNT;
+        event_count_--;
     }
+    space_cv_.notify_all();
+
+    /* NotifyClient */
+    mutex_.unlock();
+    NotifyClients(detection_ts);
     mutex_.lock();
 }
 
 void ACDEngine::EventProcessingThread(ACDEngine *engine)
 {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_EVENT, "pal_acd_evt");
+
     PAL_INFO(LOG_TAG, "Enter. start thread loop");
     if (!engine) {
         PAL_ERR(LOG_TAG, "Error:%d Invalid engine", -EINVAL);
@@ -349,7 +379,7 @@ void ACDEngine::EventProcessingThread(ACDEngine *engine)
 
     std::unique_lock<std::mutex> lck(engine->mutex_);
     while (!engine->exit_thread_) {
-        if (engine->eventQ.empty()) {
+        if (!engine->event_count_) {
             PAL_DBG(LOG_TAG, "waiting on cond");
             engine->cv_.wait(lck);
             PAL_DBG(LOG_TAG, "done waiting on cond");
@@ -364,18 +394,130 @@ void ACDEngine::EventProcessingThread(ACDEngine *engine)
     PAL_DBG(LOG_TAG, "Exit");
 }
 
+/*
+ * Folds the event in old_slot into the one in new_slot, the event right
+ * after it: a context reported by both keeps the newer entry, one reported
+ * only by the older event is carried over. Refuses, leaving both events
+ * untouched, when a context changes event type between the two (e.g. a
+ * STARTED followed by STOPPED) or the carried contexts do not fit, so no
+ * transition is lost. Called with mutex_ held.
+ */
+bool ACDEngine::CoalesceEvents(uint32_t old_slot, uint32_t new_slot)
+{
+    size_t hdr_size = sizeof(struct event_id_acd_detection_event_t) +
+                      sizeof(struct acd_key_info_t) +
+                      sizeof(struct acd_generic_key_id_reg_cfg_t);
+    size_t reg_cfg_off = sizeof(struct event_id_acd_detection_event_t) +
+                         sizeof(struct acd_key_info_t);
+    uint8_t *old_event = &event_slots_[old_slot * event_slot_size_];
+    uint8_t *new_event = &event_slots_[new_slot * event_slot_size_];
+    struct acd_generic_key_id_reg_cfg_t *old_cfg = NULL;
+    struct acd_generic_key_id_reg_cfg_t *new_cfg = NULL;
+    struct acd_per_context_event_info *old_info = NULL;
+    struct acd_per_context_event_info *new_info = NULL;
+    uint32_t old_num, new_num, carried = 0, i, j;
+
+    if (event_slot_len_[old_slot] < hdr_size)
+        return true;   /* ParseEvent would reject it anyway */
+
+    if (event_slot_len_[new_slot] < hdr_size) {
+        /* keep the valid older event in place of the malformed newer one */
+        memcpy(new_event, old_event, event_slot_len_[old_slot]);
+        event_slot_len_[new_slot] = event_slot_len_[old_slot];
+        return true;
+    }
+
+    old_cfg = (struct acd_generic_key_id_reg_cfg_t *)(old_event + reg_cfg_off);
+    new_cfg = (struct acd_generic_key_id_reg_cfg_t *)(new_event + reg_cfg_off);
+    old_info = (struct acd_per_context_event_info *)(old_event + hdr_size);
+    new_info = (struct acd_per_context_event_info *)(new_event + hdr_size);
+    old_num = (event_slot_len_[old_slot] - hdr_size) / sizeof(*old_info);
+    if (old_cfg->num_contexts < old_num)
+        old_num = old_cfg->num_contexts;
+    new_num = (event_slot_len_[new_slot] - hdr_size) / sizeof(*new_info);
+    if (new_cfg->num_contexts < new_num)
+        new_num = new_cfg->num_contexts;
+
+    for (i = 0; i < old_num; i++) {
+        for (j = 0; j < new_num; j++) {
+            if (new_info[j].context_id == old_info[i].context_id)
+                break;
+        }
+        if (j == new_num)
+            carried++;
+        else if (new_info[j].event_type != old_info[i].event_type)
+            return false;
+    }
+    if (new_num + carried > ACD_MAX_EVENT_CONTEXTS)
+        return false;
+
+    for (i = 0; i < old_num; i++) {
+        for (j = 0; j < new_num; j++) {
+            if (new_info[j].context_id == old_info[i].context_id)
+                break;
+        }
+        if (j == new_num)
+            new_info[new_num++] = old_info[i];
+    }
+    new_cfg->num_contexts = new_num;
+    event_slot_len_[new_slot] = hdr_size + new_num * sizeof(*new_info);
+    return true;
+}
+
+/*
+ * Frees one ring slot by folding the oldest pair of adjacent events that
+ * can be folded, then moving the events before it up by one slot so the
+ * ring stays in arrival order. Returns false if no pair can be folded.
+ * Called with mutex_ held.
+ */
+bool ACDEngine::CoalescePendingEvents()
+{
+    uint32_t k, i, src, dst, slot;
+
+    for (k = 0; k + 1 < event_count_; k++) {
+        slot = (event_head_ + k) % ACD_EVENT_SLOT_COUNT;
+        if (!CoalesceEvents(slot, (slot + 1) % ACD_EVENT_SLOT_COUNT))
+            continue;
+
+        for (i = k; i > 0; i--) {
+            dst = (event_head_ + i) % ACD_EVENT_SLOT_COUNT;
+            src = (event_head_ + i - 1) % ACD_EVENT_SLOT_COUNT;
+            memcpy(&event_slots_[dst * event_slot_size_],
+                   &event_slots_[src * event_slot_size_], event_slot_len_[src]);
+            event_slot_len_[dst] = event_slot_len_[src];
+        }
+        event_head_ = (event_head_ + 1) % ACD_EVENT_SLOT_COUNT;
+        event_count_--;
+        return true;
+    }
+    return false;
+}
+
 void ACDEngine::HandleSessionEvent(uint32_t event_id __unused,
                                                void *data, uint32_t size)
 {
-    void *event_data = calloc(1, size);
-    if (!event_data) {
-        PAL_ERR(LOG_TAG, "Error:failed to allocate mem for event_data");
-        return;
+    uint32_t slot;
+
+    if (size > event_slot_size_) {
+        PAL_ERR(LOG_TAG, "Error:%d event size %u exceeds slot size %zu, truncated",
+                -EINVAL, size, event_slot_size_);
+        size = event_slot_size_;
     }
 
     std::unique_lock<std::mutex> lck(mutex_);
-    memcpy(event_data, data, size);
-    eventQ.push(event_data);
+    if (event_count_ == ACD_EVENT_SLOT_COUNT && !CoalescePendingEvents()) {
+        /* every pending event carries a transition, wait for the event thread */
+        PAL_INFO(LOG_TAG, "event ring full, waiting for the event thread");
+        space_cv_.wait(lck, [this] {
+            return event_count_ < ACD_EVENT_SLOT_COUNT || exit_thread_;
+        });
+        if (exit_thread_)
+            return;
+    }
+    slot = (event_head_ + event_count_) % ACD_EVENT_SLOT_COUNT;
+    memcpy(&event_slots_[slot * event_slot_size_], data, size);
+    event_slot_len_[slot] = size;
+    event_count_++;
     cv_.notify_one();
 }
 
@@ -1162,6 +1304,7 @@ int32_t ACDEngine::TeardownEngine(Stream *st, void *config)
     }
 
     exit_thread_ = true;
+    space_cv_.notify_all();
     if (event_thread_handler_.joinable()) {
         cv_.notify_one();
         lck.unlock();
@@ -1169,6 +1312,8 @@ int32_t ACDEngine::TeardownEngine(Stream *st, void *config)
         lck.lock();
         PAL_INFO(LOG_TAG, "Thread joined");
     }
+    event_head_ = 0;
+    event_count_ = 0;
 
     /* No need to unload soundmodel as the graph/engine instance will get closed */
     status = session_->close(s);
@@ -234,6 +234,19 @@ uint32_t Session::getModuleInfo(const char *control, uint32_t tagId, uint32_t *m
     int status = 0;
     int dev = 0;
     struct mixer_ctl *mixer_ctl = NULL;
+    bool batched = false;
+
+    if (!ctl) {
+        std::lock_guard<std::mutex> lock(paramBatchMutex);
+        batched = paramBatchActive && paramBatchOwner == std::this_thread::get_id();
+        auto it = paramBatchMiids.find(std::make_pair(tagId, -1));
+        if (batched && it != paramBatchMiids.end()) {
+            *miid = it->second.first;
+            if (device)
+                *device = it->second.second;
+            return 0;
+        }
+    }
 
     if (!rxAifBackEnds.empty()) { /** search in RX GKV */
         mixer_ctl = getFEMixerCtl(control, &dev, PAL_AUDIO_OUTPUT);
@@ -279,6 +292,11 @@ uint32_t Session::getModuleInfo(const char *control, uint32_t tagId, uint32_t *m
     if (ctl)
         *ctl = mixer_ctl;
 
+    if (batched) {
+        std::lock_guard<std::mutex> lock(paramBatchMutex);
+        paramBatchMiids[std::make_pair(tagId, -1)] = std::make_pair(*miid, dev);
+    }
+
     PAL_DBG(LOG_TAG, "got miid = 0x%04x, device = %d", *miid, dev);
 exit:
     if (status) {
@@ -464,10 +482,7 @@ int Session::setEffectParametersNonTKV(Stream *s __unused, effect_pal_payload_t
         goto exit;
     }
     /* set param through set mixer param */
-    status = SessionAlsaUtils::setMixerParameter(mixer,
-            device,
-            payloadData,
-            payloadSize);
+    status = setMixerParam(device, payloadData, payloadSize);
     PAL_INFO(LOG_TAG, "mixer set param status = %d\n", status);
 
 exit:
@@ -599,6 +614,102 @@ exit:
 }
 
 
+void Session::beginParamBatch()
+{
+    std::lock_guard<std::mutex> lock(paramBatchMutex);
+
+    if (paramBatchActive) {
+        PAL_ERR(LOG_TAG, "param batch already open");
+        return;
+    }
+    paramBatchActive = true;
+    paramBatchOwner = std::this_thread::get_id();
+    paramBatchDevice = -1;
+    paramBatch.clear();
+    paramBatchMiids.clear();
+}
+
+int Session::endParamBatch()
+{
+    int status = 0;
+    int device = -1;
+    std::vector<uint8_t> batch;
+    std::unique_lock<std::mutex> lock(paramBatchMutex);
+
+    if (!paramBatchActive || paramBatchOwner != std::this_thread::get_id())
+        return 0;
+
+    paramBatchActive = false;
+    paramBatchMiids.clear();
+    batch.swap(paramBatch);
+    device = paramBatchDevice;
+    lock.unlock();
+
+    if (batch.empty())
+        return 0;
+
+    status = SessionAlsaUtils::setMixerParameter(mixer, device, batch.data(),
+                                                 batch.size());
+    PAL_DBG(LOG_TAG, "param batch of %zu bytes sent, status = %d", batch.size(), status);
+    return status;
+}
+
+int Session::setMixerParam(int device, void *payload, size_t size)
+{
+    int status = 0;
+    size_t offset = 0;
+    std::vector<uint8_t> pending;
+    std::unique_lock<std::mutex> lock(paramBatchMutex);
+
+    if (!paramBatchActive || paramBatchOwner != std::this_thread::get_id()) {
+        lock.unlock();
+        return SessionAlsaUtils::setMixerParameter(mixer, device, payload, size);
+    }
+
+    /* one setParam ioctl addresses one FE, send what was collected so far */
+    if (!paramBatch.empty() && device != paramBatchDevice) {
+        pending.swap(paramBatch);
+        status = SessionAlsaUtils::setMixerParameter(mixer, paramBatchDevice,
+                                                     pending.data(), pending.size());
+        if (status)
+            PAL_ERR(LOG_TAG, "param batch flush failed, status = %d", status);
+    }
+
+    /* APM params in one payload start 8 byte aligned */
+    offset = paramBatch.size();
+    paramBatch.resize(offset + PAL_ALIGN_8BYTE(size), 0);
+    memcpy(paramBatch.data() + offset, payload, size);
+    paramBatchDevice = device;
+
+    return status;
+}
+
+int Session::getModuleInstanceId(int device, const char *intf, uint32_t tagId,
+                                 uint32_t *miid)
+{
+    int status = 0;
+    bool batched = false;
+    std::pair<uint32_t, int> key = std::make_pair(tagId, device);
+
+    {
+        std::lock_guard<std::mutex> lock(paramBatchMutex);
+        batched = paramBatchActive && paramBatchOwner == std::this_thread::get_id();
+        auto it = paramBatchMiids.find(key);
+        if (batched && it != paramBatchMiids.end()) {
+            *miid = it->second.first;
+            return 0;
+        }
+    }
+
+    status = SessionAlsaUtils::getModuleInstanceId(mixer, device, intf, tagId, miid);
+    if (!status && batched) {
+        std::lock_guard<std::mutex> lock(paramBatchMutex);
+        paramBatchMiids[key] = std::make_pair(*miid, device);
+    }
+
+    return status;
+}
+
 int Session::updateCustomPayload(void *payload, size_t size)
 {
     if (!customPayloadSize || !customPayload) {
@@ -683,87 +683,69 @@ int SessionAlsaCompress::setCustomFormatParam(pal_audio_fmt_t audio_fmt)
     return status;
 }
 
-void SessionAlsaCompress::offloadThreadLoop(SessionAlsaCompress* compressObj)
+/* runs on a shared offload worker, one command at a time per session */
+void SessionAlsaCompress::offloadCmdHandler(void *cookie, int cmd)
 {
-    std::shared_ptr<offload_msg> msg;
+    SessionAlsaCompress *compressObj = static_cast<SessionAlsaCompress *>(cookie);
     uint32_t event_id = 0;
-    int ret = 0;
-    bool is_drain_called = false;
-    std::unique_lock<std::mutex> lock(compressObj->cv_mutex_);
-
-    while (1) {
-        if (compressObj->msg_queue_.empty())
-            compressObj->cv_.wait(lock);  /* wait for incoming requests */
-
-        if (!compressObj->msg_queue_.empty()) {
-            msg = compressObj->msg_queue_.front();
-            compressObj->msg_queue_.pop();
-            lock.unlock();
-
-            if (msg && msg->cmd == OFFLOAD_CMD_EXIT)
-                break; // exit the thread
-
-            if (msg && msg->cmd == OFFLOAD_CMD_WAIT_FOR_BUFFER) {
-                if (compressObj->rm->cardState == CARD_STATUS_ONLINE  &&
-                        compressObj->compress != NULL) {
-                    PAL_VERBOSE(LOG_TAG, "calling compress_wait");
-                    ret = compress_wait(compressObj->compress, -1);
-                    PAL_VERBOSE(LOG_TAG, "out of compress_wait, ret %d", ret);
-                    event_id = PAL_STREAM_CBK_EVENT_WRITE_READY;
-                }
-            } else if (msg && msg->cmd == OFFLOAD_CMD_DRAIN) {
-                if (!is_drain_called) {
-                    PAL_INFO(LOG_TAG, "calling compress_drain");
-                    if (compressObj->rm->cardState == CARD_STATUS_ONLINE &&
-                        compressObj->compress != NULL) {
-                         ret = compress_drain(compressObj->compress);
-                         PAL_INFO(LOG_TAG, "out of compress_drain, ret %d", ret);
-                    }
-                }
-                if (ret == -ENETRESET) {
-                    PAL_ERR(LOG_TAG, "Block drain ready event during SSR");
-                    lock.lock();
-                    continue;
+    int ret = compressObj->offloadRet;
+
+    if (cmd == OFFLOAD_CMD_WAIT_FOR_BUFFER) {
+        if (compressObj->rm->cardState == CARD_STATUS_ONLINE  &&
+                compressObj->compress != NULL) {
+            PAL_VERBOSE(LOG_TAG, "calling compress_wait");
+            ret = compress_wait(compressObj->compress, -1);
+            PAL_VERBOSE(LOG_TAG, "out of compress_wait, ret %d", ret);
+            event_id = PAL_STREAM_CBK_EVENT_WRITE_READY;
+        }
+    } else if (cmd == OFFLOAD_CMD_DRAIN) {
+        if (!compressObj->isDrainCalled) {
+            PAL_INFO(LOG_TAG, "calling compress_drain");
+            if (compressObj->rm->cardState == CARD_STATUS_ONLINE &&
+                compressObj->compress != NULL) {
+                 ret = compress_drain(compressObj->compress);
+                 PAL_INFO(LOG_TAG, "out of compress_drain, ret %d", ret);
+            }
+        }
+        compressObj->offloadRet = ret;
+        if (ret == -ENETRESET) {
+            PAL_ERR(LOG_TAG, "Block drain ready event during SSR");
+            return;
+        }
+        compressObj->isDrainCalled = false;
+        event_id = PAL_STREAM_CBK_EVENT_DRAIN_READY;
+    } else if (cmd == OFFLOAD_CMD_PARTIAL_DRAIN) {
+        if (compressObj->rm->cardState == CARD_STATUS_ONLINE &&
+                compressObj->compress != NULL) {
+            if (compressObj->isGaplessFmt) {
+                PAL_DBG(LOG_TAG, "calling partial compress_drain");
+                ret = compress_next_track(compressObj->compress);
+                PAL_INFO(LOG_TAG, "out of compress next track, ret %d", ret);
+                if (ret == 0) {
+                    ret = compress_partial_drain(compressObj->compress);
+                    PAL_INFO(LOG_TAG, "out of partial compress_drain, ret %d", ret);
                 }
-                is_drain_called = false;
+                event_id = PAL_STREAM_CBK_EVENT_PARTIAL_DRAIN_READY;
+            } else {
+                PAL_DBG(LOG_TAG, "calling compress_drain");
+                ret = compress_drain(compressObj->compress);
+                PAL_INFO(LOG_TAG, "out of compress_drain, ret %d", ret);
+                compressObj->isDrainCalled = true;
                 event_id = PAL_STREAM_CBK_EVENT_DRAIN_READY;
-            } else if (msg && msg->cmd == OFFLOAD_CMD_PARTIAL_DRAIN) {
-                if (compressObj->rm->cardState == CARD_STATUS_ONLINE &&
-                        compressObj->compress != NULL) {
-                    if (compressObj->isGaplessFmt) {
-                        PAL_DBG(LOG_TAG, "calling partial compress_drain");
-                        ret = compress_next_track(compressObj->compress);
-                        PAL_INFO(LOG_TAG, "out of compress next track, ret %d", ret);
-                        if (ret == 0) {
-                            ret = compress_partial_drain(compressObj->compress);
-                            PAL_INFO(LOG_TAG, "out of partial compress_drain, ret %d", ret);
-                        }
-                        event_id = PAL_STREAM_CBK_EVENT_PARTIAL_DRAIN_READY;
-                    } else {
-                        PAL_DBG(LOG_TAG, "calling compress_drain");
-                        ret = compress_drain(compressObj->compress);
-                        PAL_INFO(LOG_TAG, "out of compress_drain, ret %d", ret);
-                        is_drain_called = true;
-                        event_id = PAL_STREAM_CBK_EVENT_DRAIN_READY;
-                    }
-                }
-                if (ret == -ENETRESET) {
-                    PAL_ERR(LOG_TAG, "Block drain ready event during SSR");
-                    lock.lock();
-                    continue;
-                }
-            }  else if (msg && msg->cmd == OFFLOAD_CMD_ERROR) {
-                PAL_ERR(LOG_TAG, "Sending error to PAL client");
-                event_id = PAL_STREAM_CBK_EVENT_ERROR;
             }
-            if (compressObj->sessionCb)
-                compressObj->sessionCb(compressObj->cbCookie, event_id, (void*)NULL, 0);
-
-            lock.lock();
         }
-
+        compressObj->offloadRet = ret;
+        if (ret == -ENETRESET) {
+            PAL_ERR(LOG_TAG, "Block drain ready event during SSR");
+            return;
+        }
+    } else if (cmd == OFFLOAD_CMD_ERROR) {
+        PAL_ERR(LOG_TAG, "Sending error to PAL client");
+        event_id = PAL_STREAM_CBK_EVENT_ERROR;
     }
-    PAL_DBG(LOG_TAG, "exit offloadThreadLoop");
+    compressObj->offloadRet = ret;
+    if (compressObj->sessionCb)
+        compressObj->sessionCb(compressObj->cbCookie, event_id, (void*)NULL, 0);
 }
 
 SessionAlsaCompress::SessionAlsaCompress(std::shared_ptr<ResourceManager> Rm)
@@ -1238,6 +1220,9 @@ int SessionAlsaCompress::setConfig(Stream * s, configType type, int tag)
 
     switch (type) {
         case MODULE:
+            /* session time stops across a pause, drop the extrapolation base */
+            if (tag == PAUSE_TAG || tag == RESUME_TAG)
+                tsCache.invalidate();
             tkv.clear();
             status = builder->populateTagKeyVector(s, tkv, tag, &tagsent);
             if (0 != status) {
@@ -1400,6 +1385,7 @@ int SessionAlsaCompress::start(Stream * s)
     memset(&streamData, 0, sizeof(struct sessionToPayloadParam));
 
     PAL_DBG(LOG_TAG, "Enter");
+    tsCache.invalidate();
 
     memset(&dAttr, 0, sizeof(struct pal_device));
     rm->voteSleepMonitor(s, true);
@@ -1415,8 +1401,15 @@ int SessionAlsaCompress::start(Stream * s)
                 status = -EINVAL;
                 goto exit;
             }
-            /** create an offload thread for posting callbacks */
-            worker_thread = std::make_unique<std::thread>(offloadThreadLoop, this);
+            /** attach to the shared offload pool for posting callbacks */
+            isDrainCalled = false;
+            offloadRet = 0;
+            status = OffloadWorkerPool::getInstance()->attach(&offloadTask,
+                                                              offloadCmdHandler, this);
+            if (status) {
+                PAL_ERR(LOG_TAG, "offload pool attach failed %d", status);
+                goto exit;
+            }
 
             if (SND_AUDIOCODEC_AAC == codec.id &&
                 codec.ch_in < CHS_2 &&
@@ -1434,15 +1427,7 @@ int SessionAlsaCompress::start(Stream * s)
             if (!compress) {
                 PAL_ERR(LOG_TAG, "compress open failed");
                 status = -EINVAL;
-                {
-                    // send the exit command to the waiting thread
-                    auto msg = std::make_shared<offload_msg>(OFFLOAD_CMD_EXIT);
-                    std::lock_guard<std::mutex> lock(cv_mutex_);
-                    msg_queue_.push(msg);
-                    cv_.notify_all();
-                }
-                worker_thread->join();
-                worker_thread.reset(NULL);
+                OffloadWorkerPool::getInstance()->detach(&offloadTask);
                 goto exit;
             }
             if (!is_compress_ready(compress)) {
@@ -1754,6 +1739,7 @@ int SessionAlsaCompress::pause(Stream * s)
     int32_t status = 0;
 
     PAL_DBG(LOG_TAG, "Enter");
+    tsCache.invalidate();
 
     if (compress && playback_started) {
         status = compress_pause(compress);
@@ -1769,6 +1755,7 @@ int SessionAlsaCompress::resume(Stream * s __unused)
     int32_t status = 0;
 
     PAL_DBG(LOG_TAG, "Enter");
+    tsCache.invalidate();
 
     if (compress && playback_paused) {
         status = compress_resume(compress);
@@ -1787,6 +1774,7 @@ int SessionAlsaCompress::stop(Stream * s __unused)
     struct pal_stream_attributes sAttr = {};
 
     PAL_DBG(LOG_TAG, "Enter");
+    tsCache.invalidate();
 
     status = s->getStreamAttributes(&sAttr);
     if (status != 0) {
@@ -1894,26 +1882,11 @@ int SessionAlsaCompress::close(Stream * s)
                 PAL_ERR(LOG_TAG, "session alsa close failed with %d", status);
             }
             if (compress) {
-                if (PAL_CARD_STATUS_DOWN(rm->cardState)) {
-                    std::shared_ptr<offload_msg> msg = std::make_shared<offload_msg>(OFFLOAD_CMD_ERROR);
-                    std::lock_guard<std::mutex> lock(cv_mutex_);
-                    msg_queue_.push(msg);
-                    cv_.notify_all();
-                }
-                {
-                    std::shared_ptr<offload_msg> msg = std::make_shared<offload_msg>(OFFLOAD_CMD_EXIT);
-                    std::lock_guard<std::mutex> lock(cv_mutex_);
-                    msg_queue_.push(msg);
-                    cv_.notify_all();
-                }
-
-                /* wait for handler to exit */
-                worker_thread->join();
-                worker_thread.reset(NULL);
+                if (PAL_CARD_STATUS_DOWN(rm->cardState))
+                    OffloadWorkerPool::getInstance()->post(&offloadTask, OFFLOAD_CMD_ERROR);
 
-                /* empty the pending messages in queue */
-                while (!msg_queue_.empty())
-                    msg_queue_.pop();
+                /* flush pending commands and wait for the handler to go idle */
+                OffloadWorkerPool::getInstance()->detach(&offloadTask);
                 compress_close(compress);
             }
             PAL_DBG(LOG_TAG, "out of compress close");
@@ -2044,11 +2017,7 @@ int SessionAlsaCompress::write(Stream *s __unused, int tag __unused, struct pal_
 
     if (bytes_written >= 0 && bytes_written < (ssize_t)buf->size && non_blocking) {
         PAL_DBG(LOG_TAG, "No space available in compress driver, post msg to cb thread");
-        std::shared_ptr<offload_msg> msg = std::make_shared<offload_msg>(OFFLOAD_CMD_WAIT_FOR_BUFFER);
-        std::lock_guard<std::mutex> lock(cv_mutex_);
-        msg_queue_.push(msg);
-
-        cv_.notify_all();
+        OffloadWorkerPool::getInstance()->post(&offloadTask, OFFLOAD_CMD_WAIT_FOR_BUFFER);
     }
 
     if (!playback_started && bytes_written > 0) {
@@ -2168,7 +2137,7 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
                 goto exit;
             }
             pal_bt_tws_payload *tws_payload = (pal_bt_tws_payload *)payload;
-            status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+            status = getModuleInstanceId(device,
                                rxAifBackEnds[0].second.data(), tagId, &miid);
             if (0 != status) {
                 PAL_ERR(LOG_TAG, "Failed to get tag info %x, status = %d", tagId, status);
@@ -2178,8 +2147,7 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
             builder->payloadTWSConfig(&alsaParamData, &alsaPayloadSize,
                  miid, tws_payload->isTwsMonoModeOn, tws_payload->codecFormat);
             if (alsaPayloadSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               alsaParamData, alsaPayloadSize);
+                status = setMixerParam(device, alsaParamData, alsaPayloadSize);
                 PAL_INFO(LOG_TAG, "mixer set tws config status=%d\n", status);
                 freeCustomPayload(&alsaParamData, &alsaPayloadSize);
             }
@@ -2195,7 +2163,7 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
                 goto exit;
             }
             pal_bt_lc3_payload *lc3_payload = (pal_bt_lc3_payload *)payload;
-            status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+            status = getModuleInstanceId(device,
                                rxAifBackEnds[0].second.data(), tagId, &miid);
             if (0 != status) {
                 PAL_ERR(LOG_TAG, "Failed to get tag info %x, status = %d", tagId, status);
@@ -2205,8 +2173,7 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
             builder->payloadLC3Config(&alsaParamData, &alsaPayloadSize,
                  miid, lc3_payload->isLC3MonoModeOn);
             if (alsaPayloadSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               alsaParamData, alsaPayloadSize);
+                status = setMixerParam(device, alsaParamData, alsaPayloadSize);
                 PAL_INFO(LOG_TAG, "mixer set lc3 config status=%d\n", status);
                 freeCustomPayload(&alsaParamData, &alsaPayloadSize);
             }
@@ -2273,7 +2240,7 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
             status = streamHandle->getStreamAttributes(&sAttr);
             if (sAttr.direction == PAL_AUDIO_OUTPUT) {
                 device = compressDevIds.at(0);
-                status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+                status = getModuleInstanceId(device,
                         rxAifBackEnds[0].second.data(), TAG_STREAM_VOLUME, &miid);
             } else {
                 status = 0;
@@ -2293,8 +2260,7 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
             }
 
             if (alsaPayloadSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               alsaParamData, alsaPayloadSize);
+                status = setMixerParam(device, alsaParamData, alsaPayloadSize);
                 PAL_INFO(LOG_TAG, "mixer set volume config status=%d\n", status);
                 freeCustomPayload(&alsaParamData, &alsaPayloadSize);
                 alsaPayloadSize = 0;
@@ -2311,7 +2277,7 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
                 goto exit;
             }
             pal_param_mspp_linear_gain_t *linear_gain = (pal_param_mspp_linear_gain_t *)payload;
-            status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+            status = getModuleInstanceId(device,
                                rxAifBackEnds[0].second.data(), tagId, &miid);
 
             PAL_DBG(LOG_TAG, "set MSPP linear gain");
@@ -2322,8 +2288,7 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
 
             builder->payloadMSPPConfig(&alsaParamData, &alsaPayloadSize, miid, linear_gain->gain);
             if (alsaPayloadSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               alsaParamData, alsaPayloadSize);
+                status = setMixerParam(device, alsaParamData, alsaPayloadSize);
                 PAL_INFO(LOG_TAG, "mixer set MSPP config status=%d\n", status);
                 free(alsaParamData);
             }
@@ -2340,13 +2305,12 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
                 goto exit;
             }
             struct pal_vol_ctrl_ramp_param *rampParam = (struct pal_vol_ctrl_ramp_param *)payload;
-            status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+            status = getModuleInstanceId(device,
                                rxAifBackEnds[0].second.data(), tagId, &miid);
             builder->payloadVolumeCtrlRamp(&alsaParamData, &alsaPayloadSize,
                  miid, rampParam->ramp_period_ms);
             if (alsaPayloadSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               alsaParamData, alsaPayloadSize);
+                status = setMixerParam(device, alsaParamData, alsaPayloadSize);
                 PAL_INFO(LOG_TAG, "mixer set vol ctrl ramp status=%d\n", status);
                 freeCustomPayload(&alsaParamData, &alsaPayloadSize);
             }
@@ -2412,14 +2376,13 @@ int SessionAlsaCompress::setParameters(Stream *s __unused, int tagId, uint32_t p
             pal_param_playback_rate_t *playbackRate =
                                         (pal_param_playback_rate_t *)(param_payload->payload);
             PAL_DBG(LOG_TAG, "speed %f, pitch %f", playbackRate->speed, playbackRate->pitch);
-            status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+            status = getModuleInstanceId(device,
                                rxAifBackEnds[0].second.data(), TAG_MODULE_TSM, &miid);
 
             builder->payloadPlaybackRateParametersConfig(&alsaParamData, &alsaPayloadSize,
                                                             miid, playbackRate);
             if (alsaPayloadSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               alsaParamData, alsaPayloadSize);
+                status = setMixerParam(device, alsaParamData, alsaPayloadSize);
                 PAL_INFO(LOG_TAG, "mixer set playbackRate parameters status=%d", status);
                 freeCustomPayload(&alsaParamData, &alsaPayloadSize);
             }
@@ -2445,6 +2408,7 @@ int SessionAlsaCompress::flush()
 {
     int status = 0;
     PAL_VERBOSE(LOG_TAG, "Enter flush");
+    tsCache.invalidate();
 
     if (playback_started) {
         if (compressDevIds.size() > 0) {
@@ -2461,7 +2425,7 @@ int SessionAlsaCompress::flush()
 
 int SessionAlsaCompress::drain(pal_drain_type_t type)
 {
-    std::shared_ptr<offload_msg> msg;
+    int status = 0;
 
     if (!compress) {
        PAL_ERR(LOG_TAG, "compress is invalid");
@@ -2472,29 +2436,20 @@ int SessionAlsaCompress::drain(pal_drain_type_t type)
 
     switch (type) {
     case PAL_DRAIN:
-    {
-        msg = std::make_shared<offload_msg>(OFFLOAD_CMD_DRAIN);
-        std::lock_guard<std::mutex> drain_lock(cv_mutex_);
-        msg_queue_.push(msg);
-        cv_.notify_all();
-    }
-    break;
+        status = OffloadWorkerPool::getInstance()->post(&offloadTask, OFFLOAD_CMD_DRAIN);
+        break;
 
     case PAL_DRAIN_PARTIAL:
-    {
-        msg = std::make_shared<offload_msg>(OFFLOAD_CMD_PARTIAL_DRAIN);
-        std::lock_guard<std::mutex> partial_lock(cv_mutex_);
-        msg_queue_.push(msg);
-        cv_.notify_all();
-    }
-    break;
+        status = OffloadWorkerPool::getInstance()->post(&offloadTask,
+                                                         OFFLOAD_CMD_PARTIAL_DRAIN);
+        break;
 
     default:
         PAL_ERR(LOG_TAG, "invalid drain type = %d", type);
         return -EINVAL;
     }
 
-    return 0;
+    return status;
 }
 
 int SessionAlsaCompress::getParameters(Stream *s __unused, int tagId __unused, uint32_t param_id __unused, void **payload __unused)
@@ -2505,11 +2460,27 @@ int SessionAlsaCompress::getParameters(Stream *s __unused, int tagId __unused, u
 int SessionAlsaCompress::getTimestamp(struct pal_session_time *stime)
 {
     int status = 0;
-    status = SessionAlsaUtils::getTimestamp(mixer, compressDevIds, spr_miid, stime);
-    if (0 != status) {
-       PAL_ERR(LOG_TAG, "getTimestamp failed status = %d", status);
-       return status;
+    pal_timestamp_info_t info;
+
+    status = getTimestampInfo(&info);
+    if (0 == status)
+        *stime = info.stime;
+
+    return status;
+}
+
+int SessionAlsaCompress::getTimestampInfo(pal_timestamp_info_t *info, bool fresh)
+{
+    int status = 0;
+
+    if (compressDevIds.size() == 0) {
+        PAL_ERR(LOG_TAG, "DevIds size is invalid");
+        return -EINVAL;
     }
+    status = tsCache.getTimestamp(mixer, compressDevIds.at(0), spr_miid, info, fresh);
+    if (0 != status)
+       PAL_ERR(LOG_TAG, "getTimestamp failed status = %d", status);
+
     return status;
 }
 
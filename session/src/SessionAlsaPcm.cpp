@@ -629,6 +629,9 @@ int SessionAlsaPcm::setConfig(Stream * s, configType type, int tag)
     PAL_DBG(LOG_TAG, "Enter tag: %d", tag);
     switch (type) {
         case MODULE:
+            /* session time stops across a pause, drop the extrapolation base */
+            if (tag == PAUSE_TAG || tag == RESUME_TAG)
+                tsCache.invalidate();
             tkv.clear();
             status = builder->populateTagKeyVector(s, tkv, tag, &tagsent);
             if (0 != status) {
@@ -945,6 +948,7 @@ int SessionAlsaPcm::start(Stream * s)
     bool isStreamAvail = false;
 
     PAL_DBG(LOG_TAG, "Enter");
+    tsCache.invalidate();
 
     memset(&dAttr, 0, sizeof(struct pal_device));
     rm->voteSleepMonitor(s, true);
@@ -1908,6 +1912,7 @@ int SessionAlsaPcm::stop(Stream * s)
     int DeviceId;
 
     PAL_DBG(LOG_TAG, "Enter");
+    tsCache.invalidate();
     status = s->getStreamAttributes(&sAttr);
     if (status != 0) {
         PAL_ERR(LOG_TAG, "stream get attributes failed");
@@ -2711,7 +2716,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
         case PAL_PARAM_ID_BT_A2DP_TWS_CONFIG:
         {
             pal_bt_tws_payload *tws_payload = (pal_bt_tws_payload *)payload;
-            status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+            status = getModuleInstanceId(device,
                                rxAifBackEnds[0].second.data(), tagId, &miid);
             if (0 != status) {
                 PAL_ERR(LOG_TAG, "Failed to get tag info %x, status = %d", tagId, status);
@@ -2721,8 +2726,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
             builder->payloadTWSConfig(&paramData, &paramSize, miid,
                     tws_payload->isTwsMonoModeOn, tws_payload->codecFormat);
             if (paramSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               paramData, paramSize);
+                status = setMixerParam(device, paramData, paramSize);
                 PAL_INFO(LOG_TAG, "mixer set tws config status=%d\n", status);
                 freeCustomPayload(&paramData, &paramSize);
             }
@@ -2731,7 +2735,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
         case PAL_PARAM_ID_BT_A2DP_LC3_CONFIG:
         {
             pal_bt_lc3_payload *lc3_payload = (pal_bt_lc3_payload *)payload;
-            status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+            status = getModuleInstanceId(device,
                                rxAifBackEnds[0].second.data(), tagId, &miid);
             if (0 != status) {
                 PAL_ERR(LOG_TAG, "Failed to get tag info %x, status = %d", tagId, status);
@@ -2741,8 +2745,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
             builder->payloadLC3Config(&paramData, &paramSize, miid,
                     lc3_payload->isLC3MonoModeOn);
             if (paramSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               paramData, paramSize);
+                status = setMixerParam(device, paramData, paramSize);
                 PAL_INFO(LOG_TAG, "mixer set lc3 config status=%d\n", status);
                 freeCustomPayload(&paramData, &paramSize);
             }
@@ -2752,9 +2755,8 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
         {
             pal_param_payload *param_payload = (pal_param_payload *)payload;
             if (param_payload->payload_size) {
-                 status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                                              param_payload->payload,
-                                                              param_payload->payload_size);
+                 status = setMixerParam(device, param_payload->payload,
+                                       param_payload->payload_size);
                  PAL_INFO(LOG_TAG, "mixer set module config status=%d\n", status);
             }
             return 0;
@@ -2777,23 +2779,22 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
                 goto exit;
             }
             if (sAttr.direction == PAL_AUDIO_OUTPUT) {
-                status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+                status = getModuleInstanceId(device,
                         rxAifBackEnds[0].second.data(), TAG_STREAM_VOLUME, &miid);
             } else if (sAttr.direction == PAL_AUDIO_INPUT) {
-                status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+                status = getModuleInstanceId(device,
                         txAifBackEnds[0].second.data(), TAG_STREAM_VOLUME, &miid);
             } else if (sAttr.direction == (PAL_AUDIO_INPUT | PAL_AUDIO_OUTPUT)) {
                 status = -EINVAL;
                 if (pcmDevRxIds.size()) {
                     device = pcmDevRxIds.at(0);
-                    status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+                    status = getModuleInstanceId(device,
                             rxAifBackEnds[0].second.data(), TAG_STREAM_VOLUME, &miid);
                     if (status) {
                         if (pcmDevTxIds.size() > 0)
                             device = pcmDevTxIds.at(0);
-                        status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
-                                                                       txAifBackEnds[0].second.data(),
-                                                                       tagId, &miid);
+                        status = getModuleInstanceId(device,
+                                txAifBackEnds[0].second.data(), tagId, &miid);
                     }
                 }
             } else {
@@ -2814,8 +2815,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
             }
 
             if (paramSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               paramData, paramSize);
+                status = setMixerParam(device, paramData, paramSize);
                 PAL_INFO(LOG_TAG, "mixer set volume config status=%d\n", status);
                 freeCustomPayload(&paramData, &paramSize);
                 paramSize = 0;
@@ -2827,7 +2827,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
             pal_param_mspp_linear_gain_t *linear_gain = (pal_param_mspp_linear_gain_t *)payload;
             device = pcmDevIds.at(0)
             ;
-            status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+            status = getModuleInstanceId(device,
                                rxAifBackEnds[0].second.data(), tagId, &miid);
             PAL_INFO(LOG_TAG, "Set mspp linear gain");
             if (0 != status) {
@@ -2837,8 +2837,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
 
             builder->payloadMSPPConfig(&paramData, &paramSize, miid, linear_gain->gain);
             if (paramSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               paramData, paramSize);
+                status = setMixerParam(device, paramData, paramSize);
                 PAL_INFO(LOG_TAG, "mixer set MSPP config status=%d\n", status);
                 free(paramData);
             }
@@ -2938,7 +2937,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
         case PAL_PARAM_ID_VOLUME_CTRL_RAMP:
         {
             struct pal_vol_ctrl_ramp_param *rampParam = (struct pal_vol_ctrl_ramp_param *)payload;
-            status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+            status = getModuleInstanceId(device,
                                rxAifBackEnds[0].second.data(), tagId, &miid);
             if (0 != status) {
                 PAL_ERR(LOG_TAG, "Failed to get tag info %x, status = %d", tagId, status);
@@ -2947,8 +2946,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
             builder->payloadVolumeCtrlRamp(&paramData, &paramSize,
                  miid, rampParam->ramp_period_ms);
             if (paramSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               paramData, paramSize);
+                status = setMixerParam(device, paramData, paramSize);
                 PAL_INFO(LOG_TAG, "mixer set vol ctrl ramp status=%d\n", status);
                 freeCustomPayload(&paramData, &paramSize);
             }
@@ -3048,7 +3046,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
             }
             if (sAttr.direction == PAL_AUDIO_OUTPUT &&
                (sAttr.type == PAL_STREAM_DEEP_BUFFER || PAL_STREAM_PCM_OFFLOAD)) {
-                status = SessionAlsaUtils::getModuleInstanceId(mixer, device,
+                status = getModuleInstanceId(device,
                          rxAifBackEnds[0].second.data(), tagId, &miid);
                 PAL_DBG(LOG_TAG, "Gainlog - Get MIID status - %d", status);
             } else {
@@ -3063,8 +3061,7 @@ int SessionAlsaPcm::setParameters(Stream *streamHandle, int tagId, uint32_t para
             builder->payloadGainConfig(&paramData, &paramSize, miid, gdata);
 
             if (paramSize) {
-                status = SessionAlsaUtils::setMixerParameter(mixer, device,
-                                               paramData, paramSize);
+                status = setMixerParam(device, paramData, paramSize);
                 PAL_DBG(LOG_TAG, "GainLog - mixer set gain config status=%d\n", status);
                 freeCustomPayload(&paramData, &paramSize);
             }
@@ -3515,6 +3512,18 @@ int SessionAlsaPcm::registerCallBack(session_callback cb, uint64_t cookie)
 }
 
 int SessionAlsaPcm::getTimestamp(struct pal_session_time *stime)
+{
+    int status = 0;
+    pal_timestamp_info_t info;
+
+    status = getTimestampInfo(&info);
+    if (0 == status)
+        *stime = info.stime;
+
+    return status;
+}
+
+int SessionAlsaPcm::getTimestampInfo(pal_timestamp_info_t *info, bool fresh)
 {
     int status = 0;
 
@@ -3533,7 +3542,7 @@ int SessionAlsaPcm::getTimestamp(struct pal_session_time *stime)
             return status;
         }
     }
-    status = SessionAlsaUtils::getTimestamp(mixer, pcmDevIds, spr_miid, stime);
+    status = tsCache.getTimestamp(mixer, pcmDevIds.at(0), spr_miid, info, fresh);
     if (0 != status)
        PAL_ERR(LOG_TAG, "getTimestamp failed status = %d", status);
 
@@ -3549,6 +3558,7 @@ int SessionAlsaPcm::flush()
 {
     int status = 0;
     PAL_VERBOSE(LOG_TAG, "Enter flush");
+    tsCache.invalidate();
 
     if (pcmDevIds.size() > 0) {
         status = SessionAlsaUtils::flush(rm, pcmDevIds.at(0));
@@ -1077,72 +1077,6 @@ int SessionAlsaUtils::setDeviceMediaConfig(std::shared_ptr<ResourceManager> rmHa
                                sizeof(aif_media_config)/sizeof(aif_media_config[0]));
 }
 
-int SessionAlsaUtils::getTimestamp(struct mixer *mixer, const std::vector<int> &DevIds,
-                                   uint32_t spr_miid, struct pal_session_time *stime)
-{
-    int status = 0;
-    const char *getParamControl = "getParam";
-    char *pcmDeviceName = NULL;
-    std::ostringstream CntrlName;
-    struct mixer_ctl *ctl;
-    struct param_id_spr_session_time_t *spr_session_time;
-    std::shared_ptr<std::vector<uint8_t>> payload = nullptr;
-    size_t payloadSize = 0;
-    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
-
-    if (DevIds.size() > 0) {
-        pcmDeviceName = rm->getDeviceNameFromID(DevIds.at(0));
-    } else {
-        PAL_ERR(LOG_TAG, "DevIds size is invalid");
-        return -EINVAL;
-    }
-
-    if(!pcmDeviceName){
-        PAL_ERR(LOG_TAG, "Device name from id not found");
-        return -EINVAL;
-    }
-    CntrlName<<pcmDeviceName<<" "<<getParamControl;
-    ctl = mixer_get_ctl_by_name(mixer, CntrlName.str().data());
-    if (!ctl) {
-        PAL_ERR(LOG_TAG, "Invalid mixer control: %s\n", CntrlName.str().data());
-        return -ENOENT;
-    }
-
-    PayloadBuilder* builder = new PayloadBuilder();
-    builder->payloadTimestamp(payload, &payloadSize, spr_miid);
-    if (!payload) {
-        PAL_ERR(LOG_TAG, "Timestamp payload formation failed");
-        status = -EINVAL;
-        goto exit;
-    }
-    status = mixer_ctl_set_array(ctl, payload->data(), payloadSize);
-    if (0 != status) {
-         PAL_ERR(LOG_TAG, "Set failed status = %d", status);
-         goto exit;
-    }
-    memset(payload->data(), 0, payloadSize);
-    status = mixer_ctl_get_array(ctl, payload->data(), payloadSize);
-    if (0 != status) {
-         PAL_ERR(LOG_TAG, "Get failed status = %d", status);
-         goto exit;
-    }
-    spr_session_time = (struct param_id_spr_session_time_t *)
-                     (payload->data() + sizeof(struct apm_module_param_data_t));
-    stime->session_time.value_lsw = spr_session_time->session_time.value_lsw;
-    stime->session_time.value_msw = spr_session_time->session_time.value_msw;
-    stime->absolute_time.value_lsw = spr_session_time->absolute_time.value_lsw;
-    stime->absolute_time.value_msw = spr_session_time->absolute_time.value_msw;
-    stime->timestamp.value_lsw = spr_session_time->timestamp.value_lsw;
-    stime->timestamp.value_msw = spr_session_time->timestamp.value_msw;
-    //flags from Spf are igonred
-exit:
-    if(builder) {
-       delete builder;
-       builder = NULL;
-    }
-    return status;
-}
-
 int SessionAlsaUtils::getModuleInstanceId(struct mixer *mixer, int device, const char *intf_name,
                        int tag_id, uint32_t *miid)
 {
@@ -835,22 +835,16 @@ int SessionAlsaVoice::setTaggedSlotMask(Stream * s)
     return status;
 }
 
-int SessionAlsaVoice::start(Stream * s)
+/*
+ * Opens the Rx and Tx hostless PCMs and sends everything that does not
+ * depend on the call being answered. On failure the caller tears down.
+ */
+int SessionAlsaVoice::stageGraph(Stream * s, std::shared_ptr<Device> rxDevice)
 {
     struct pcm_config config;
     struct pal_stream_attributes sAttr;
     int32_t status = 0;
-    std::shared_ptr<Device> rxDevice = nullptr;
     pal_param_payload *palPayload = NULL;
-    int txDevId = PAL_DEVICE_NONE;
-    uint8_t* payload = NULL;
-    size_t payloadSize = 0;
-    struct pal_volume_data *volume = NULL;
-    bool isTxStarted = false, isRxStarted = false;
-
-    PAL_DBG(LOG_TAG,"Enter");
-
-    rm->voteSleepMonitor(s, true);
 
     status = s->getStreamAttributes(&sAttr);
     if (status != 0) {
@@ -876,24 +870,19 @@ int SessionAlsaVoice::start(Stream * s)
     config.silence_threshold = 0;
 
     /*setup external ec if needed*/
-    status = getRXDevice(s, rxDevice);
-    if (status) {
-        PAL_ERR(LOG_TAG, "failed, could not find associated RX device");
-        goto exit;
-    }
     setExtECRef(s, rxDevice, true);
 
     pcmRx = pcm_open(rm->getVirtualSndCard(), pcmDevRxIds.at(0), PCM_OUT, &config);
     if (!pcmRx) {
         PAL_ERR(LOG_TAG, "Exit pcm-rx open failed");
         status = -EINVAL;
-        goto err_pcm_open;
+        goto exit;
     }
 
     if (!pcm_is_ready(pcmRx)) {
         PAL_ERR(LOG_TAG, "Exit pcm-rx open not ready");
         status = -EINVAL;
-        goto err_pcm_open;
+        goto exit;
     }
 
     config.rate = sAttr.in_media_config.sample_rate;
@@ -911,46 +900,22 @@ int SessionAlsaVoice::start(Stream * s)
     if (!pcmTx) {
         PAL_ERR(LOG_TAG, "Exit pcm-tx open failed");
         status = -EINVAL;
-        goto err_pcm_open;
+        goto exit;
     }
 
     if (!pcm_is_ready(pcmTx)) {
         PAL_ERR(LOG_TAG, "Exit pcm-tx open not ready");
         status = -EINVAL;
-        goto err_pcm_open;
+        goto exit;
     }
 
     status = SessionAlsaVoice::setConfig(s, MODULE, VSID, RX_HOSTLESS);
     if (status) {
         PAL_ERR(LOG_TAG, "setConfig failed %d", status);
-        goto err_pcm_open;
+        goto exit;
     }
 
     SessionAlsaVoice::setConfig(s, MODULE, CHANNEL_INFO, TX_HOSTLESS);
-    volume = (struct pal_volume_data *)malloc(sizeof(uint32_t) +
-                                                (sizeof(struct pal_channel_vol_kv)));
-    if (!volume) {
-        status = -ENOMEM;
-        PAL_ERR(LOG_TAG, "volume malloc failed %s", strerror(errno));
-        goto err_pcm_open;
-    }
-
-    /*if no volume is set set a default volume*/
-    if ((s->getVolumeData(volume))) {
-        PAL_INFO(LOG_TAG, "no volume set, setting default vol to %f",
-                 default_volume);
-        volume->no_of_volpair = 1;
-        volume->volume_pair[0].channel_mask = 1;
-        volume->volume_pair[0].vol = default_volume;
-        /*call will cache the volume but not apply it as stream has not moved to start state*/
-        s->setVolume(volume);
-    };
-    /*call to apply volume*/
-    if (rm->isCRSCallEnabled) {
-        setConfig(s, MODULE, CRS_CALL_VOLUME, RX_HOSTLESS);
-    } else {
-        setConfig(s, CALIBRATION, TAG_STREAM_VOLUME, RX_HOSTLESS);
-    }
 
     /*set tty mode*/
     if (ttyMode) {
@@ -968,27 +933,156 @@ int SessionAlsaVoice::start(Stream * s)
 
     if (status != 0) {
         PAL_ERR(LOG_TAG,"Exit Configuring Rx mfc failed with status %d", status);
-        goto err_pcm_open;
+        goto exit;
     }
     status = SessionAlsaUtils::setMixerParameter(mixer, pcmDevRxIds.at(0),
                                                  customPayload, customPayloadSize);
     freeCustomPayload();
     if (status != 0) {
         PAL_ERR(LOG_TAG,"setMixerParameter failed");
-        goto err_pcm_open;
+        goto exit;
     }
 
     /* set slot_mask as TKV to configure MUX module */
     status = setTaggedSlotMask(s);
     if (status != 0) {
         PAL_ERR(LOG_TAG,"setTaggedSlotMask failed");
-        goto err_pcm_open;
+        goto exit;
     }
 
     if (ResourceManager::isLpiLoggingEnabled()) {
         status = payloadTaged(s, MODULE, LPI_LOGGING_ON, pcmDevTxIds.at(0), TX_HOSTLESS);
         if (status)
             PAL_ERR(LOG_TAG, "Failed to set data logging param status = %d", status);
+        status = 0;
+    }
+
+exit:
+    freeCustomPayload();
+    if (palPayload)
+        free(palPayload);
+    return status;
+}
+
+int SessionAlsaVoice::prearm(Stream * s)
+{
+    int32_t status = 0;
+    std::shared_ptr<Device> rxDevice = nullptr;
+
+    PAL_DBG(LOG_TAG, "Enter");
+    if (prearmed)
+        goto exit;
+    if (pcmRx || pcmTx) {
+        PAL_ERR(LOG_TAG, "voice graph already open");
+        status = -EALREADY;
+        goto exit;
+    }
+
+    status = getRXDevice(s, rxDevice);
+    if (status) {
+        PAL_ERR(LOG_TAG, "failed, could not find associated RX device");
+        goto exit;
+    }
+
+    /* held until the graph is committed and stopped, or disarmed */
+    rm->voteSleepMonitor(s, true);
+    status = stageGraph(s, rxDevice);
+    if (status) {
+        PAL_ERR(LOG_TAG, "staging voice graph failed %d", status);
+        setExtECRef(s, rxDevice, false);
+        if (pcmRx) {
+            pcm_close(pcmRx);
+            pcmRx = NULL;
+        }
+        if (pcmTx) {
+            pcm_close(pcmTx);
+            pcmTx = NULL;
+        }
+        rm->voteSleepMonitor(s, false);
+        goto exit;
+    }
+    prearmed = true;
+
+exit:
+    PAL_DBG(LOG_TAG, "Exit ret: %d", status);
+    return status;
+}
+
+int SessionAlsaVoice::disarm(Stream * s)
+{
+    std::shared_ptr<Device> rxDevice = nullptr;
+
+    if (!prearmed)
+        return 0;
+
+    PAL_DBG(LOG_TAG, "dropping pre-armed voice graph");
+    prearmed = false;
+    if (!getRXDevice(s, rxDevice))
+        setExtECRef(s, rxDevice, false);
+    if (pcmRx) {
+        pcm_close(pcmRx);
+        pcmRx = NULL;
+    }
+    if (pcmTx) {
+        pcm_close(pcmTx);
+        pcmTx = NULL;
+    }
+    rm->voteSleepMonitor(s, false);
+    return 0;
+}
+
+int SessionAlsaVoice::start(Stream * s)
+{
+    int32_t status = 0;
+    std::shared_ptr<Device> rxDevice = nullptr;
+    int txDevId = PAL_DEVICE_NONE;
+    struct pal_volume_data *volume = NULL;
+    bool isTxStarted = false, isRxStarted = false;
+
+    PAL_DBG(LOG_TAG,"Enter");
+
+    status = getRXDevice(s, rxDevice);
+    if (status) {
+        PAL_ERR(LOG_TAG, "failed, could not find associated RX device");
+        disarm(s);
+        PAL_DBG(LOG_TAG,"Exit ret: %d", status);
+        return status;
+    }
+
+    if (prearmed) {
+        /* graph was staged by prearm(), the sleep monitor vote is already held */
+        PAL_INFO(LOG_TAG, "committing pre-armed voice graph");
+        prearmed = false;
+    } else {
+        rm->voteSleepMonitor(s, true);
+        status = stageGraph(s, rxDevice);
+        if (status)
+            goto err_pcm_open;
+    }
+
+    volume = (struct pal_volume_data *)malloc(sizeof(uint32_t) +
+                                                (sizeof(struct pal_channel_vol_kv)));
+    if (!volume) {
+        status = -ENOMEM;
+        PAL_ERR(LOG_TAG, "volume malloc failed %s", strerror(errno));
+        goto err_pcm_open;
+    }
+
+    /*if no volume is set set a default volume*/
+    if ((s->getVolumeData(volume))) {
+        PAL_INFO(LOG_TAG, "no volume set, setting default vol to %f",
+                 default_volume);
+        volume->no_of_volpair = 1;
+        volume->volume_pair[0].channel_mask = 1;
+        volume->volume_pair[0].vol = default_volume;
+        /*call will cache the volume but not apply it as stream has not moved to start state*/
+        s->setVolume(volume);
+    };
+    /*call to apply volume*/
+    if (rm->isCRSCallEnabled) {
+        setConfig(s, MODULE, CRS_CALL_VOLUME, RX_HOSTLESS);
+    } else {
+        setConfig(s, CALIBRATION, TAG_STREAM_VOLUME, RX_HOSTLESS);
     }
 
     if (ResourceManager::isChargeConcurrencyEnabled) {
@@ -1074,12 +1168,6 @@ err_pcm_open:
      }
 
 exit:
-    freeCustomPayload();
-    if (payload)
-        free(payload);
-    if (palPayload) {
-        free(palPayload);
-    }
     if (volume)
         free(volume);
     if (status)
@@ -1148,6 +1236,7 @@ int SessionAlsaVoice::close(Stream * s)
     std::vector<std::pair<std::string, int>> freeDeviceMetadata;
 
     PAL_DBG(LOG_TAG,"Enter");
+    disarm(s);
     status = s->getStreamAttributes(&sAttr);
     if (status != 0) {
         PAL_ERR(LOG_TAG,"stream get attributes failed");
@@ -1981,6 +2070,50 @@ int SessionAlsaVoice::setupSessionDevice(Stream* streamHandle,
     return status;
 }
 
+/*
+ * Drops the external EC ref taken by setupSessionDevice for deviceToRelease
+ * and points the front end, its metadata and the cached backends back at
+ * deviceInUse, the device of the same direction that is still connected.
+ */
+int SessionAlsaVoice::releaseSessionDevice(Stream *streamHandle,
+                                           pal_stream_type_t streamType,
+                                           std::shared_ptr<Device> deviceToRelease,
+                                           std::shared_ptr<Device> deviceInUse)
+{
+    std::vector<std::shared_ptr<Device>> deviceList;
+    struct pal_device dAttr;
+    int status = 0;
+
+    deviceToRelease->getDeviceAttributes(&dAttr);
+    if (SessionAlsaUtils::isRxDevice(dAttr.id)) {
+        setExtECRef(streamHandle, deviceToRelease, false);
+    }
+
+    if (!deviceInUse)
+        return 0;
+
+    deviceList.push_back(deviceInUse);
+    rm->getBackEndNames(deviceList, rxAifBackEnds, txAifBackEnds);
+    deviceInUse->getDeviceAttributes(&dAttr);
+
+    if (rxAifBackEnds.size() > 0) {
+        status =  SessionAlsaUtils::setupSessionDevice(streamHandle, streamType,
+                                                       rm, dAttr, pcmDevRxIds,
+                                                       rxAifBackEnds);
+        if(0 != status) {
+            PAL_ERR(LOG_TAG,"restoring session device on RX Failed");
+        }
+    } else if (txAifBackEnds.size() > 0) {
+        status =  SessionAlsaUtils::setupSessionDevice(streamHandle, streamType,
+                                                       rm, dAttr, pcmDevTxIds,
+                                                       txAifBackEnds);
+        if(0 != status) {
+            PAL_ERR(LOG_TAG,"restoring session device on TX Failed");
+        }
+    }
+    return status;
+}
+
 int SessionAlsaVoice::connectSessionDevice(Stream* streamHandle,
                                            pal_stream_type_t streamType,
                                            std::shared_ptr<Device> deviceToConnect)
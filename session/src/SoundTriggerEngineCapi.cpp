@@ -46,6 +46,7 @@
 #include "Stream.h"
 #include "SoundTriggerPlatformInfo.h"
 #include "VoiceUIInterface.h"
+#include "ThreadPolicy.h"
 
 #define CNN_BUFFER_LENGTH 10000
 #define CNN_FRAME_SIZE 320
@@ -56,6 +57,8 @@ ST_DBG_DECLARE(static int user_verification_cnt = 0);
 void SoundTriggerEngineCapi::BufferThreadLoop(
     SoundTriggerEngineCapi *capi_engine)
 {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_CAPTURE, "pal_st_lab");
+
     StreamSoundTrigger *s = nullptr;
     int32_t status = 0;
     int32_t detection_state = ENGINE_IDLE;
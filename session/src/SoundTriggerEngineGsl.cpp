@@ -69,6 +69,8 @@ std::condition_variable cvEOS;
 void SoundTriggerEngineGsl::EventProcessingThread(
     SoundTriggerEngineGsl *gsl_engine) {
 
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_CAPTURE, "pal_st_gsl");
+
     if (!gsl_engine) {
         PAL_ERR(LOG_TAG, "Invalid sound trigger engine");
         return;
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: TimestampCache"
+
+#include "TimestampCache.h"
+#include "ResourceManager.h"
+#include "PayloadBuilder.h"
+#include <time.h>
+
+TimestampCache::TimestampCache()
+    : mixer_(nullptr),
+      ctl_(nullptr),
+      devId_(-1),
+      sprMiid_(0),
+      lastQueryUs_(0),
+      lastReturnedUs_(0),
+      valid_(false),
+      advancing_(false)
+{
+    memset(&last_, 0, sizeof(last_));
+}
+
+uint64_t TimestampCache::nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t TimestampCache::toUs(const struct pal_time_us &t)
+{
+    return ((uint64_t)t.value_msw << 32) | t.value_lsw;
+}
+
+void TimestampCache::fromUs(uint64_t us, struct pal_time_us *t)
+{
+    t->value_lsw = (uint32_t)us;
+    t->value_msw = (uint32_t)(us >> 32);
+}
+
+void TimestampCache::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    valid_ = false;
+    advancing_ = false;
+    lastReturnedUs_ = 0;
+}
+
+int TimestampCache::setup_l(struct mixer *mixer, int devId, uint32_t sprMiid)
+{
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+    std::shared_ptr<std::vector<uint8_t>> payload = nullptr;
+    size_t payloadSize = 0;
+    char *pcmDeviceName = NULL;
+    std::string cntrlName;
+    PayloadBuilder builder;
+
+    if (mixer != mixer_ || devId != devId_) {
+        pcmDeviceName = rm->getDeviceNameFromID(devId);
+        if (!pcmDeviceName) {
+            PAL_ERR(LOG_TAG, "Device name from id not found");
+            return -EINVAL;
+        }
+        cntrlName = std::string(pcmDeviceName) + " getParam";
+        ctl_ = mixer_get_ctl_by_name(mixer, cntrlName.c_str());
+        if (!ctl_) {
+            PAL_ERR(LOG_TAG, "Invalid mixer control: %s\n", cntrlName.c_str());
+            mixer_ = nullptr;
+            return -ENOENT;
+        }
+        mixer_ = mixer;
+        devId_ = devId;
+        valid_ = false;
+    }
+
+    if (sprMiid != sprMiid_ || request_.empty()) {
+        builder.payloadTimestamp(payload, &payloadSize, sprMiid);
+        if (!payload) {
+            PAL_ERR(LOG_TAG, "Timestamp payload formation failed");
+            return -EINVAL;
+        }
+        request_.assign(payload->begin(), payload->begin() + payloadSize);
+        response_.resize(payloadSize);
+        sprMiid_ = sprMiid;
+        valid_ = false;
+    }
+
+    return 0;
+}
+
+int TimestampCache::query_l(struct pal_session_time *stime)
+{
+    int status = 0;
+    struct param_id_spr_session_time_t *spr_session_time;
+
+    status = mixer_ctl_set_array(ctl_, request_.data(), request_.size());
+    if (0 != status) {
+         PAL_ERR(LOG_TAG, "Set failed status = %d", status);
+         return status;
+    }
+    memset(response_.data(), 0, response_.size());
+    status = mixer_ctl_get_array(ctl_, response_.data(), response_.size());
+    if (0 != status) {
+         PAL_ERR(LOG_TAG, "Get failed status = %d", status);
+         return status;
+    }
+    spr_session_time = (struct param_id_spr_session_time_t *)
+                     (response_.data() + sizeof(struct apm_module_param_data_t));
+    stime->session_time.value_lsw = spr_session_time->session_time.value_lsw;
+    stime->session_time.value_msw = spr_session_time->session_time.value_msw;
+    stime->absolute_time.value_lsw = spr_session_time->absolute_time.value_lsw;
+    stime->absolute_time.value_msw = spr_session_time->absolute_time.value_msw;
+    stime->timestamp.value_lsw = spr_session_time->timestamp.value_lsw;
+    stime->timestamp.value_msw = spr_session_time->timestamp.value_msw;
+    //flags from Spf are igonred
+
+    return status;
+}
+
+int TimestampCache::getTimestamp(struct mixer *mixer, int devId, uint32_t sprMiid,
+                                 pal_timestamp_info_t *info, bool fresh)
+{
+    int status = 0;
+    uint64_t now = 0, age = 0, sessionUs = 0;
+    struct pal_session_time cur;
+    struct pal_session_time *stime = &info->stime;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    status = setup_l(mixer, devId, sprMiid);
+    if (status)
+        return status;
+
+    now = nowUs();
+    age = now - lastQueryUs_;
+    if (fresh || !valid_ || age >= PAL_TIMESTAMP_QUERY_INTERVAL_US) {
+        status = query_l(&cur);
+        if (status) {
+            valid_ = false;
+            return status;
+        }
+        /* only extrapolate once the DSP has shown the session moving */
+        advancing_ = valid_ &&
+                toUs(cur.session_time) > toUs(last_.session_time);
+        last_ = cur;
+        lastQueryUs_ = now;
+        valid_ = true;
+        age = 0;
+    }
+
+    *stime = last_;
+    if (fresh) {
+        /* the caller wants the DSP's own view, no extrapolation or clamping */
+        info->age_us = 0;
+        info->extrapolated = 0;
+        return status;
+    }
+    if (age && advancing_) {
+        fromUs(toUs(last_.session_time) + age, &stime->session_time);
+        fromUs(toUs(last_.absolute_time) + age, &stime->absolute_time);
+        fromUs(toUs(last_.timestamp) + age, &stime->timestamp);
+    }
+
+    /* a fresh reading may trail the previous extrapolation, never go back */
+    sessionUs = toUs(stime->session_time);
+    if (sessionUs < lastReturnedUs_)
+        fromUs(lastReturnedUs_, &stime->session_time);
+    else
+        lastReturnedUs_ = sessionUs;
+
+    info->age_us = age;
+    info->extrapolated = (age && advancing_) ? 1 : 0;
+
+    return status;
+}
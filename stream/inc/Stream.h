@@ -72,6 +72,8 @@
 #include <math.h>
 #include <memory>
 #include <mutex>
+#include <deque>
+#include <atomic>
 #include <exception>
 #include <semaphore.h>
 #include <errno.h>
@@ -79,6 +81,7 @@
 #include <condition_variable>
 #endif
 #include "PalCommon.h"
+#include "OffloadWorkerPool.h"
 
 typedef enum {
     DATA_MODE_SHMEM = 0,
@@ -175,6 +178,19 @@ typedef enum {
 class Device;
 class ResourceManager;
 class Session;
+class CaptureProfile;
+
+/* control ops a writer can run on behalf of a caller, see Stream::postControl */
+enum {
+    STREAM_CTRL_VOLUME,
+    STREAM_CTRL_MUTE,
+};
+
+struct stream_ctrl_cmd {
+    int cmd;
+    uint64_t seq;   /* client volume sequence, see Stream::setVolumeOrdered */
+    std::vector<uint8_t> data;
+};
 
 class Stream
 {
@@ -188,7 +204,8 @@ protected:
     int mOrientation = 0;
     std::mutex mStreamMutex;
     std::mutex mGetParamMutex;
-    static std::mutex mBaseStreamMutex; //TBD change this. as having a single static mutex for all instances of Stream is incorrect. Replace
+    /* orders device config negotiation across concurrent Stream::create calls */
+    static std::mutex mStreamCreateMutex;
     static std::shared_ptr<ResourceManager> rm;
     struct modifier_kv *mModifiers;
     uint32_t mNoOfModifiers;
@@ -203,8 +220,19 @@ protected:
     stream_state_t currentState;
     stream_state_t cachedState;
     uint32_t mInstanceID = 0;
-    static std::condition_variable pauseCV;
-    static std::mutex pauseMutex;
+    std::condition_variable pauseCV;
+    std::mutex pauseMutex;
+    bool pauseDone = false;
+    std::mutex mCtrlMutex;
+    std::deque<struct stream_ctrl_cmd> mCtrlQueue;
+    bool mTransferInFlight = false;
+    /* both called with mStreamMutex held, around a blocking session write */
+    void beginTransfer_l();
+    void endTransfer_l();
+    /* last issued client volume sequence, and the last one applied */
+    std::atomic<uint64_t> mVolumeSeq{0};
+    uint64_t mVolumeAppliedSeq = 0;
+    int32_t applyVolume_l(struct pal_volume_data *volume, uint64_t seq);
     bool mutexLockedbyRm = false;
     bool mDutyCycleEnable = false;
     bool skipSSRHandling = false;
@@ -223,6 +251,29 @@ public:
     bool force_nlpi_vote = false;
     bool isMMap = false;
     bool isComboHeadsetActive = false;
+    /* ordered executor state of the pal_stream_*_async APIs */
+    struct offload_task asyncTask;
+    std::mutex asyncMutex;
+    std::deque<std::vector<struct pal_device>> asyncDevices;
+    std::atomic<uint32_t> asyncPending{0};
+    pal_stream_callback asyncCb = NULL;
+    uint64_t asyncCookie = 0;
+    bool asyncCloseFree = false;
+    /*
+     * Queues a control op if a data transfer currently holds mStreamMutex,
+     * in which case the writer runs it, in post order, as soon as the
+     * transfer returns. Returns false if nothing is in flight and the caller
+     * should take mStreamMutex itself.
+     */
+    bool postControl(int cmd, const void *data, size_t size, uint64_t seq = 0);
+    /* stamps a client volume update, later stamps win over earlier ones */
+    uint64_t nextVolumeSeq() { return ++mVolumeSeq; }
+    /*
+     * Applies a client volume stamped with seq, or queues it behind a
+     * transfer. Dropped if a newer stamped volume has already been applied,
+     * so the newest update lands last whichever path each one takes.
+     */
+    int32_t setVolumeOrdered(struct pal_volume_data *volume, uint64_t seq);
 #ifdef LINUX_ENABLED
     bool ecref_op = false;
     std::condition_variable ecref_cv;
@@ -291,14 +342,29 @@ public:
     /* static so that this method can be accessed wihtout object */
     static Stream* create(struct pal_stream_attributes *sattr, struct pal_device *dattr,
          uint32_t no_of_devices, struct modifier_kv *modifiers, uint32_t no_of_modifiers);
+    static int32_t resolveDeviceConfig(struct pal_stream_attributes *sattr,
+                                       struct pal_device *dattr);
     bool isStreamAudioOutFmtSupported(pal_audio_fmt_t format);
     int32_t getTimestamp(struct pal_session_time *stime);
+    /* fresh: bypass the session's timestamp cache */
+    int32_t getTimestampInfo(pal_timestamp_info_t *info, bool fresh = false);
     int32_t handleBTDeviceNotReadyToDummy(bool& a2dpSuspend);
     int32_t handleBTDeviceNotReady(bool& a2dpSuspend);
     int disconnectStreamDevice(Stream* streamHandle,  pal_device_id_t dev_id);
     int disconnectStreamDevice_l(Stream* streamHandle,  pal_device_id_t dev_id);
     int connectStreamDevice(Stream* streamHandle, struct pal_device *dattr);
     int connectStreamDevice_l(Stream* streamHandle, struct pal_device *dattr);
+    /*
+     * Make-before-break device switch: prepare brings up the new device and
+     * its session leg while the old one keeps running, commit swaps the
+     * session over to it and releases the old device, abort undoes prepare.
+     */
+    int prepareStreamDevice_l(Stream* streamHandle, struct pal_device *dattr,
+                              std::shared_ptr<Device> &dev);
+    int commitStreamDevice_l(Stream* streamHandle, pal_device_id_t oldDevId,
+                             std::shared_ptr<Device> dev, uint32_t *gapMs);
+    void abortStreamDevice_l(Stream* streamHandle, std::shared_ptr<Device> dev,
+                             bool started = true);
     int switchDevice(Stream* streamHandle, uint32_t no_of_devices, struct pal_device *deviceArray);
     bool isGKVMatch(pal_key_vector_t* gkv);
     int32_t getEffectParameters(void *effect_query, size_t *payload_size);
@@ -313,6 +379,8 @@ public:
     bool isStreamSSRDownFeasibile();
     int32_t getEffectParameters(void *effect_query);
     int32_t setEffectParameters(void *effect_param);
+    int32_t setParameterBatch(uint32_t noOfParams, uint32_t *paramIds,
+                              pal_param_payload **payloads);
     int32_t rwACDBParameters(void *payload, uint32_t sampleRate,
                                 bool isParamWrite);
     stream_state_t getCurState() { return currentState; }
@@ -323,10 +391,20 @@ public:
     virtual int32_t Resume() { return 0; }
     virtual int32_t Pause() { return 0; }
     virtual int32_t HandleConcurrentStream(bool active) { return 0; }
+    /* whether an LPI/NLPI switch moves the stream to another capture profile */
+    virtual bool IsCaptureProfileChanged() { return true; }
+    /* shared rule for the above, there is nothing to switch to without a new profile */
+    static bool IsCaptureProfileSwitch(const std::shared_ptr<CaptureProfile> &cur,
+                                       const std::shared_ptr<CaptureProfile> &next)
+    {
+        return next && next != cur;
+    }
     virtual int32_t DisconnectDevice(pal_device_id_t device_id) { return 0; }
     virtual int32_t ConnectDevice(pal_device_id_t device_id) { return 0; }
     static void handleSoftPauseCallBack(uint64_t hdl, uint32_t event_id, void *data,
                                                            uint32_t event_size);
+    void signalPauseDone();
+    bool waitPauseDone(std::unique_lock<std::mutex> &pauseLock, uint32_t timeoutUs);
     static void handleStreamException(struct pal_stream_attributes *attributes,
                                       pal_stream_callback cb, uint64_t cookie);
     void lockStreamMutex() {
@@ -131,6 +131,7 @@ class StreamACD : public Stream {
     int32_t Resume() override;
     int32_t Pause() override;
     int32_t HandleConcurrentStream(bool active) override;
+    bool IsCaptureProfileChanged() override;
 
     pal_device_id_t GetAvailCaptureDevice();
     std::shared_ptr<CaptureProfile> GetCurrentCaptureProfile();
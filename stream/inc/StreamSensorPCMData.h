@@ -58,6 +58,7 @@ public:
     int32_t Resume() override;
     int32_t Pause() override;
     int32_t HandleConcurrentStream(bool active) override;
+    bool IsCaptureProfileChanged() override;
     int32_t DisconnectDevice(pal_device_id_t device_id) override;
     int32_t ConnectDevice(pal_device_id_t device_id) override;
     pal_device_id_t GetAvailCaptureDevice();
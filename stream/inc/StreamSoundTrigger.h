@@ -162,6 +162,7 @@ public:
     int32_t Pause() override;
     int32_t GetCurrentStateId();
     int32_t HandleConcurrentStream(bool active);
+    bool IsCaptureProfileChanged() override;
     int32_t setECRef(std::shared_ptr<Device> dev, bool is_enable) override;
     int32_t setECRef_l(std::shared_ptr<Device> dev, bool is_enable) override;
     bool ConfigSupportLPI() override;
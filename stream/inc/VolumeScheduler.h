@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef VOLUME_SCHEDULER_H
+#define VOLUME_SCHEDULER_H
+
+#include "PalDefs.h"
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/*
+ * Kept below the default DSP volume ramp (DEFAULT_RAMP_PERIOD, 40ms) so a
+ * coalesced update still ramps across the whole gap it replaces.
+ */
+#define VOLUME_COALESCE_WINDOW_MS 30
+
+class Stream;
+
+struct volume_sched_entry {
+    std::chrono::steady_clock::time_point lastApplied;
+    std::vector<uint8_t> pending;
+    uint64_t pendingSeq = 0;
+    bool hasPending = false;
+};
+
+/*
+ * Coalesces client volume updates per stream. The first update
+ * after a quiet window is applied right away; updates arriving within
+ * VOLUME_COALESCE_WINDOW_MS of it only replace the pending value, which a
+ * single worker applies when the window closes. All streams due in the
+ * same window are flushed in one pass, so ducking several streams costs
+ * one volume set per stream per window rather than one per call.
+ * Every update carries the stream's volume sequence number, so an update
+ * applied by the caller never lands after a newer one applied here.
+ */
+class VolumeScheduler {
+public:
+    static VolumeScheduler* getInstance();
+
+    /*
+     * Returns true if the update was queued, false if the caller should
+     * apply it now (the window is then restarted from this update).
+     */
+    bool defer(Stream *s, const struct pal_volume_data *volume, uint64_t seq);
+    /* drops pending updates, waits for one in progress; no stream locks held */
+    void cancel(Stream *s);
+
+protected:
+    VolumeScheduler();
+    static void workerLoop(VolumeScheduler *sched);
+    static void apply(Stream *s, struct pal_volume_data *volume, uint64_t seq);
+
+    std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable busyCv_;
+    std::map<Stream *, struct volume_sched_entry> entries_;
+    Stream *busy_;
+    bool workerStarted_;
+};
+
+#endif /* VOLUME_SCHEDULER_H */
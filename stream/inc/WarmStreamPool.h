@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef WARM_STREAM_POOL_H
+#define WARM_STREAM_POOL_H
+
+#include "PalDefs.h"
+#include <stdint.h>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+/*
+ * parked streams not reused within this window are closed, a parked stream
+ * keeps its device open, "warm_stream_idle_ms" overrides the default
+ */
+#define PAL_WARM_STREAM_IDLE_TIMEOUT_MS 3000
+
+class Stream;
+
+struct warm_stream_entry {
+    Stream *stream;
+    struct pal_stream_attributes attr;
+    struct pal_device dev;
+    uint64_t parkedAtMs;
+};
+
+/*
+ * Pool of opened but idle low latency playback streams, keyed by stream
+ * attributes and output device. pal_stream_close() parks eligible streams
+ * instead of tearing down their graph, pal_stream_open() hands a matching
+ * one back, and a background thread re-warms a replacement after each hit
+ * and closes streams idle for the idle timeout. Any device switch or
+ * config param change drops the parked streams, and acquire re-resolves
+ * the device config so a stream is reused only if a cold open would
+ * configure the same device.
+ * Disabled unless "warm_stream_pool_size" is set in the RM config params.
+ */
+class WarmStreamPool {
+public:
+    static void setPoolSize(uint32_t size);
+    static void setIdleTimeout(uint32_t timeoutMs);
+    static bool canPark(Stream *s);
+    static int32_t quiesce(Stream *s);
+    static bool park(Stream *s);
+    static Stream* acquire(struct pal_stream_attributes *sAttr, uint32_t noOfDevices,
+                           struct pal_device *devices, uint32_t noOfModifiers);
+    /* close all parked streams now, returns true if any were closed */
+    static bool flush();
+    /* drop parked streams from the pool thread, safe under RM locks */
+    static void invalidate();
+    static void deinit();
+
+protected:
+    static bool isEligible(const struct pal_stream_attributes *sAttr,
+                           uint32_t noOfDevices, const struct pal_device *devices,
+                           uint32_t noOfModifiers);
+    static bool isMatch(const struct warm_stream_entry &entry,
+                        const struct pal_stream_attributes *sAttr,
+                        const struct pal_device *dev);
+    static bool isDeviceConfigCurrent(const struct warm_stream_entry &entry,
+                                      struct pal_stream_attributes *sAttr);
+    static uint32_t countForDevice_l(pal_device_id_t id);
+    static void closeStreams(std::vector<Stream *> &streams);
+    static void startThread_l();
+    static void poolThreadLoop();
+    static uint64_t nowMs();
+
+    static std::mutex mutex_;
+    static std::condition_variable cv_;
+    static std::thread poolThread_;
+    static std::vector<struct warm_stream_entry> parked_;
+    static std::vector<struct warm_stream_entry> rewarmQ_;
+    static uint32_t poolSize_;
+    static uint32_t idleTimeoutMs_;
+    static bool invalidated_;
+    static bool exit_;
+};
+
+#endif /* WARM_STREAM_POOL_H */
@@ -53,9 +53,7 @@
 #include "mem_logger.h"
 
 std::shared_ptr<ResourceManager> Stream::rm = nullptr;
-std::mutex Stream::mBaseStreamMutex;
-std::mutex Stream::pauseMutex;
-std::condition_variable Stream::pauseCV;
+std::mutex Stream::mStreamCreateMutex;
 
 
 void Stream::handleSoftPauseCallBack(uint64_t hdl, uint32_t event_id,
@@ -66,14 +64,73 @@ void Stream::handleSoftPauseCallBack(uint64_t hdl, uint32_t event_id,
 
     if (event_id == EVENT_ID_SOFT_PAUSE_PAUSE_COMPLETE) {
         PAL_DBG(LOG_TAG, "Pause done");
-        pauseCV.notify_all();
+        reinterpret_cast<Stream *>(hdl)->signalPauseDone();
     }
 }
 
+void Stream::signalPauseDone()
+{
+    {
+        std::lock_guard<std::mutex> lock(pauseMutex);
+        pauseDone = true;
+    }
+    pauseCV.notify_all();
+}
+
+/*
+ * Called with pauseLock held on pauseMutex, after PAUSE_TAG was sent with
+ * pauseDone cleared. Returns false if the pause event did not arrive in time.
+ */
+bool Stream::waitPauseDone(std::unique_lock<std::mutex> &pauseLock, uint32_t timeoutUs)
+{
+    return pauseCV.wait_for(pauseLock, std::chrono::microseconds(timeoutUs),
+                            [this] { return pauseDone; });
+}
+
+/*
+ * Resolves the config Stream::create would pick for a single device of a
+ * new stream right now, so a stream reused from the warm pool can be
+ * checked against it. dattr carries the id and custom key on entry.
+ */
+int32_t Stream::resolveDeviceConfig(struct pal_stream_attributes *sAttr,
+                                    struct pal_device *dAttr)
+{
+    std::lock_guard<std::mutex> lock(mStreamCreateMutex);
+    std::vector <Stream *> streamsToSwitch;
+    struct pal_device streamDevAttr;
+    int32_t status = 0;
+
+    if (!rm) {
+        rm = ResourceManager::getInstance();
+        if (!rm)
+            return -EINVAL;
+    }
+
+    status = rm->getDeviceConfig(dAttr, sAttr);
+    if (status) {
+        PAL_ERR(LOG_TAG, "Not able to get Device config %d", status);
+        return status;
+    }
+    rm->lockActiveStream();
+    status = rm->checkAndUpdateGroupDevConfig(dAttr, sAttr, streamsToSwitch,
+                                              &streamDevAttr, true);
+    rm->unlockActiveStream();
+    if (status)
+        PAL_ERR(LOG_TAG, "no valid group device config found");
+
+    if (!rm->is_multiple_sample_rate_combo_supported)
+        rm->checkAndUpdateHeadsetDevConfig(dAttr, false);
+
+    if (!rm->isStreamSupported(sAttr, dAttr, 1))
+        return -EINVAL;
+
+    return 0;
+}
+
 Stream* Stream::create(struct pal_stream_attributes *sAttr, struct pal_device *dAttr,
     uint32_t noOfDevices, struct modifier_kv *modifiers, uint32_t noOfModifiers)
 {
-    std::lock_guard<std::mutex> lock(mBaseStreamMutex);
+    std::unique_lock<std::mutex> lock(mStreamCreateMutex);
     Stream* stream = NULL;
     int status = 0;
     uint32_t count = 0;
@@ -98,6 +155,14 @@ Stream* Stream::create(struct pal_stream_attributes *sAttr, struct pal_device *d
     }
     PAL_VERBOSE(LOG_TAG,"get RM instance success and noOfDevices %d \n", noOfDevices);
 
+    /*
+     * Streams without devices take no part in device config negotiation and
+     * can be constructed in parallel with other creates.
+     */
+    if (sAttr->type == PAL_STREAM_NON_TUNNEL || sAttr->type == PAL_STREAM_CONTEXT_PROXY ||
+        sAttr->type == PAL_STREAM_COMMON_PROXY)
+        lock.unlock();
+
     palDevsAttr = (pal_device *)calloc(noOfDevices, sizeof(struct pal_device));
     if (!palDevsAttr) {
         PAL_ERR(LOG_TAG, "palDevsAttr not created");
@@ -312,6 +377,91 @@ exit:
     return stream;
 }
 
+bool Stream::postControl(int cmd, const void *data, size_t size, uint64_t seq)
+{
+    struct stream_ctrl_cmd ctrl;
+    std::lock_guard<std::mutex> lock(mCtrlMutex);
+
+    if (!mTransferInFlight || !data)
+        return false;
+
+    ctrl.cmd = cmd;
+    ctrl.seq = seq;
+    ctrl.data.assign((const uint8_t *)data, (const uint8_t *)data + size);
+    mCtrlQueue.push_back(std::move(ctrl));
+    PAL_VERBOSE(LOG_TAG, "control op %d queued behind transfer", cmd);
+
+    return true;
+}
+
+int32_t Stream::applyVolume_l(struct pal_volume_data *volume, uint64_t seq)
+{
+    if (seq && seq <= mVolumeAppliedSeq) {
+        PAL_VERBOSE(LOG_TAG, "volume %llu superseded by %llu, dropped",
+                    (unsigned long long)seq, (unsigned long long)mVolumeAppliedSeq);
+        return 0;
+    }
+    if (seq)
+        mVolumeAppliedSeq = seq;
+
+    return setVolume(volume);
+}
+
+int32_t Stream::setVolumeOrdered(struct pal_volume_data *volume, uint64_t seq)
+{
+    int32_t status = 0;
+    size_t size = sizeof(uint32_t) +
+                  sizeof(struct pal_channel_vol_kv) * volume->no_of_volpair;
+
+    if (postControl(STREAM_CTRL_VOLUME, volume, size, seq))
+        return 0;
+
+    lockStreamMutex();
+    status = applyVolume_l(volume, seq);
+    unlockStreamMutex();
+
+    return status;
+}
+
+void Stream::beginTransfer_l()
+{
+    std::lock_guard<std::mutex> lock(mCtrlMutex);
+
+    mTransferInFlight = true;
+}
+
+void Stream::endTransfer_l()
+{
+    struct stream_ctrl_cmd ctrl;
+    int32_t status = 0;
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mCtrlMutex);
+            if (mCtrlQueue.empty()) {
+                mTransferInFlight = false;
+                return;
+            }
+            ctrl = std::move(mCtrlQueue.front());
+            mCtrlQueue.pop_front();
+        }
+
+        switch (ctrl.cmd) {
+            case STREAM_CTRL_VOLUME:
+                status = applyVolume_l((struct pal_volume_data *)ctrl.data.data(), ctrl.seq);
+                break;
+            case STREAM_CTRL_MUTE:
+                status = mute_l(*(bool *)ctrl.data.data());
+                break;
+            default:
+                status = -EINVAL;
+                break;
+        }
+        if (status)
+            PAL_ERR(LOG_TAG, "queued control op %d failed %d", ctrl.cmd, status);
+    }
+}
+
 int32_t  Stream::getStreamAttributes(struct pal_stream_attributes *sAttr)
 {
     int32_t status = 0;
@@ -410,6 +560,41 @@ int32_t Stream::setEffectParameters(void *effect_param)
 
     return status;
 }
+/*
+ * Applies params in order through the single param path while the session
+ * collects their setParam payloads, then sends them in one ioctl. Params
+ * that are not plain setParam payloads still take effect immediately.
+ */
+int32_t Stream::setParameterBatch(uint32_t noOfParams, uint32_t *paramIds,
+                                  pal_param_payload **payloads)
+{
+    int32_t status = 0, flushStatus = 0;
+    uint32_t i = 0;
+
+    if (!session) {
+        PAL_ERR(LOG_TAG, "invalid session");
+        return -EINVAL;
+    }
+
+    session->beginParamBatch();
+    for (i = 0; i < noOfParams; i++) {
+        if (PAL_PARAM_ID_UIEFFECT == paramIds[i])
+            status = setEffectParameters((void *)payloads[i]);
+        else
+            status = setParameters(paramIds[i], (void *)payloads[i]);
+        if (0 != status) {
+            PAL_ERR(LOG_TAG, "param %u (id %u) failed, status %d", i, paramIds[i], status);
+            break;
+        }
+    }
+    /* params ahead of a failing one are still applied */
+    flushStatus = session->endParamBatch();
+    if (0 != flushStatus)
+        PAL_ERR(LOG_TAG, "batched setParam failed, status %d", flushStatus);
+
+    return status ? status : flushStatus;
+}
+
 int32_t Stream::rwACDBParameters(void *payload, uint32_t sampleRate,
                                     bool isParamWrite)
 {
@@ -850,9 +1035,26 @@ bool Stream::isStreamAudioOutFmtSupported(pal_audio_fmt_t format)
 int32_t Stream::getTimestamp(struct pal_session_time *stime)
 {
     int32_t status = 0;
+    pal_timestamp_info_t info;
+
     if (!stime) {
         status = -EINVAL;
         PAL_ERR(LOG_TAG, "Invalid session time pointer, status %d", status);
+        return status;
+    }
+    status = getTimestampInfo(&info);
+    if (0 == status)
+        *stime = info.stime;
+
+    return status;
+}
+
+int32_t Stream::getTimestampInfo(pal_timestamp_info_t *info, bool fresh)
+{
+    int32_t status = 0;
+    if (!info) {
+        status = -EINVAL;
+        PAL_ERR(LOG_TAG, "Invalid timestamp info pointer, status %d", status);
         goto exit;
     }
     if (PAL_CARD_STATUS_DOWN(rm->cardState)) {
@@ -861,7 +1063,7 @@ int32_t Stream::getTimestamp(struct pal_session_time *stime)
         goto exit;
     }
     mGetParamMutex.lock();
-    status = session->getTimestamp(stime);
+    status = session->getTimestampInfo(info, fresh);
     mGetParamMutex.unlock();
     if (0 != status) {
         PAL_ERR(LOG_TAG, "Failed to get session timestamp status %d", status);
@@ -1603,6 +1805,158 @@ case 7
     same as case 4.
 
 */
+int32_t Stream::prepareStreamDevice_l(Stream* streamHandle, struct pal_device *dattr,
+                                      std::shared_ptr<Device> &dev)
+{
+    int32_t status = 0;
+    std::string newBackEndName;
+    std::string curBackEndName;
+
+    dev = Device::getInstance(dattr, rm);
+    if (!dev) {
+        PAL_ERR(LOG_TAG, "Device creation failed");
+        return -ENODEV;
+    }
+
+    /* both legs run at once, so the new one needs a backend of its own */
+    rm->getBackendName(dattr->id, newBackEndName);
+    for (auto iter = mDevices.begin(); iter != mDevices.end(); iter++) {
+        rm->getBackendName((*iter)->getSndDeviceId(), curBackEndName);
+        if (newBackEndName == curBackEndName) {
+            PAL_DBG(LOG_TAG, "device %d shares backend with device %d",
+                    dattr->id, (*iter)->getSndDeviceId());
+            dev = nullptr;
+            return -EBUSY;
+        }
+    }
+
+    dev->setDeviceAttributes(*dattr);
+
+    if (ResourceManager::isChargeConcurrencyEnabled &&
+        dev->getSndDeviceId() == PAL_DEVICE_OUT_SPEAKER &&
+        !rm->getConcurrentBoostState() && !rm->getInputCurrentLimitorConfigStatus())
+        rm->chargerListenerSetBoostState(true, PB_ON_CHARGER_INSERT);
+
+    status = dev->open();
+    if (0 != status) {
+        PAL_ERR(LOG_TAG, "device %d open failed with status %d", dattr->id, status);
+        dev = nullptr;
+        return status;
+    }
+
+    status = session->setupSessionDevice(streamHandle, mStreamAttr->type, dev);
+    if (0 != status) {
+        PAL_ERR(LOG_TAG, "setupSessionDevice for %d failed with status %d",
+                dattr->id, status);
+        abortStreamDevice_l(streamHandle, dev, false);
+        dev = nullptr;
+        return status;
+    }
+
+    rm->lockGraph();
+    status = dev->start();
+    rm->unlockGraph();
+    if (0 != status) {
+        PAL_ERR(LOG_TAG, "device %d start failed with status %d", dattr->id, status);
+        abortStreamDevice_l(streamHandle, dev, false);
+        dev = nullptr;
+    }
+    return status;
+}
+
+int32_t Stream::commitStreamDevice_l(Stream* streamHandle, pal_device_id_t oldDevId,
+                                     std::shared_ptr<Device> dev, uint32_t *gapMs)
+{
+    int32_t status = 0;
+    int32_t idx = -1;
+    std::shared_ptr<Device> oldDev = nullptr;
+    std::chrono::steady_clock::time_point swapStart;
+
+    for (int i = 0; i < mDevices.size(); i++) {
+        if (mDevices[i]->getSndDeviceId() == oldDevId) {
+            oldDev = mDevices[i];
+            idx = i;
+            break;
+        }
+    }
+    if (!oldDev) {
+        PAL_ERR(LOG_TAG, "device %d not attached to stream", oldDevId);
+        return -EINVAL;
+    }
+
+    rm->deregisterDevice(oldDev, this);
+    if (oldDevId == PAL_DEVICE_OUT_SPEAKER && ResourceManager::isSpeakerProtectionEnabled) {
+        status = oldDev->stop();
+        if (0 != status)
+            PAL_ERR(LOG_TAG, "device stop failed with status %d", status);
+    }
+
+    swapStart = std::chrono::steady_clock::now();
+    rm->lockGraph();
+    status = session->disconnectSessionDevice(streamHandle, mStreamAttr->type, oldDev);
+    if (0 != status) {
+        PAL_ERR(LOG_TAG, "disconnectSessionDevice failed:%d", status);
+        rm->unlockGraph();
+        rm->registerDevice(oldDev, this);
+        return status;
+    }
+    status = session->connectSessionDevice(streamHandle, mStreamAttr->type, dev);
+    *gapMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - swapStart).count();
+    if (0 != status) {
+        PAL_ERR(LOG_TAG, "connectSessionDevice failed:%d, restoring device %d",
+                status, oldDevId);
+        if (session->setupSessionDevice(streamHandle, mStreamAttr->type, oldDev) ||
+            session->connectSessionDevice(streamHandle, mStreamAttr->type, oldDev))
+            PAL_ERR(LOG_TAG, "restoring device %d failed", oldDevId);
+        rm->unlockGraph();
+        rm->registerDevice(oldDev, this);
+        return status;
+    }
+    mDevices[idx] = dev;
+
+    /* the new leg carries the stream now, release the old one */
+    oldDev->stop();
+    oldDev->close();
+    rm->unlockGraph();
+    rm->registerDevice(dev, this);
+    rm->checkAndSetDutyCycleParam();
+    palStateEnqueue(streamHandle, (pal_state_queue_state) currentState, status);
+
+    if (ResourceManager::isChargeConcurrencyEnabled &&
+        (dev->getSndDeviceId() == PAL_DEVICE_OUT_SPEAKER) && rm->getConcurrentBoostState()
+        && !rm->getInputCurrentLimitorConfigStatus() && rm->getChargerOnlineState())
+        rm->setSessionParamConfig(PAL_PARAM_ID_CHARGER_STATE, streamHandle,
+                                  CHARGE_CONCURRENCY_ON_TAG);
+    return 0;
+}
+
+void Stream::abortStreamDevice_l(Stream* streamHandle, std::shared_ptr<Device> dev,
+                                 bool started)
+{
+    std::shared_ptr<Device> inUse = nullptr;
+    bool isOut = dev->getSndDeviceId() > PAL_DEVICE_OUT_MIN &&
+                 dev->getSndDeviceId() < PAL_DEVICE_OUT_MAX;
+
+    /* the leg still carrying this direction gets the session routing back */
+    for (auto iter = mDevices.begin(); iter != mDevices.end(); iter++) {
+        bool curIsOut = (*iter)->getSndDeviceId() > PAL_DEVICE_OUT_MIN &&
+                        (*iter)->getSndDeviceId() < PAL_DEVICE_OUT_MAX;
+        if (*iter != dev && curIsOut == isOut) {
+            inUse = *iter;
+            break;
+        }
+    }
+
+    rm->lockGraph();
+    if (session->releaseSessionDevice(streamHandle, mStreamAttr->type, dev, inUse))
+        PAL_ERR(LOG_TAG, "releasing session device %d failed", dev->getSndDeviceId());
+    if (started)
+        dev->stop();
+    rm->unlockGraph();
+    dev->close();
+}
+
 int32_t Stream::switchDevice(Stream* streamHandle, uint32_t numDev, struct pal_device *newDevices)
 {
     int32_t status = 0;
@@ -1639,6 +1993,8 @@ int32_t Stream::switchDevice(Stream* streamHandle, uint32_t numDev, struct pal_d
         return -EINVAL;
     }
 
+    /* a pre-armed voice graph was staged for the old devices */
+    session->disarm(this);
     streamHandle->getStreamAttributes(&strAttr);
 
     for (int i = 0; i < mDevices.size(); i++) {
@@ -315,6 +315,17 @@ int32_t StreamACD::HandleConcurrentStream(bool active) {
     return status;
 }
 
+bool StreamACD::IsCaptureProfileChanged()
+{
+    std::lock_guard<std::mutex> lck(mStreamMutex);
+
+    // nothing to switch before the stream is loaded
+    if (GetCurrentStateId() == ACD_STATE_IDLE)
+        return false;
+
+    return IsCaptureProfileSwitch(cap_prof_, GetCurrentCaptureProfile());
+}
+
 int32_t StreamACD::getParameters(uint32_t param_id __unused, void **payload __unused)
 {
     return 0;
@@ -980,6 +991,8 @@ exit:
 
 void StreamACD::EventNotificationThread(StreamACD *stream)
 {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_EVENT, "pal_acd_notify");
+
     PAL_DBG(LOG_TAG, "Enter. start thread loop");
 
     std::unique_lock<std::mutex> lck(stream->mutex_);
@@ -1360,37 +1373,33 @@ int32_t StreamACD::ACDLoaded::ProcessEvent(
                 status = -EINVAL;
                 break;
             }
-            if (acd_stream_.cap_prof_ != new_cap_prof) {
-                PAL_DBG(LOG_TAG,
-                    "current capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
-                    acd_stream_.cap_prof_->GetName().c_str(),
-                    acd_stream_.cap_prof_->GetDevId(),
-                    acd_stream_.cap_prof_->GetChannels(),
-                    acd_stream_.cap_prof_->GetSampleRate(),
-                    acd_stream_.cap_prof_->isECRequired());
-                PAL_DBG(LOG_TAG,
-                    "new capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
-                    new_cap_prof->GetName().c_str(),
-                    new_cap_prof->GetDevId(),
-                    new_cap_prof->GetChannels(),
-                    new_cap_prof->GetSampleRate(),
-                    new_cap_prof->isECRequired());
-                if (!active) {
-                    std::shared_ptr<ACDEventConfig> ev_cfg1(
-                        new ACDDeviceDisconnectedEventConfig(acd_stream_.GetAvailCaptureDevice()));
-                    status = acd_stream_.ProcessInternalEvent(ev_cfg1);
-                    if (status)
-                        PAL_ERR(LOG_TAG, "Error:%d Failed to disconnect device %d", status,
-                                    acd_stream_.GetAvailCaptureDevice());
-                } else {
-                    std::shared_ptr<ACDEventConfig> ev_cfg1(
-                        new ACDDeviceConnectedEventConfig(acd_stream_.GetAvailCaptureDevice()));
-                    status = acd_stream_.ProcessInternalEvent(ev_cfg1);
-                    if (status)
-                        PAL_ERR(LOG_TAG, "Error:%d Failed to connect device %d", status, acd_stream_.GetAvailCaptureDevice());
-                }
+            PAL_DBG(LOG_TAG,
+                "current capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
+                acd_stream_.cap_prof_->GetName().c_str(),
+                acd_stream_.cap_prof_->GetDevId(),
+                acd_stream_.cap_prof_->GetChannels(),
+                acd_stream_.cap_prof_->GetSampleRate(),
+                acd_stream_.cap_prof_->isECRequired());
+            PAL_DBG(LOG_TAG,
+                "new capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
+                new_cap_prof->GetName().c_str(),
+                new_cap_prof->GetDevId(),
+                new_cap_prof->GetChannels(),
+                new_cap_prof->GetSampleRate(),
+                new_cap_prof->isECRequired());
+            if (!active) {
+                std::shared_ptr<ACDEventConfig> ev_cfg1(
+                    new ACDDeviceDisconnectedEventConfig(acd_stream_.GetAvailCaptureDevice()));
+                status = acd_stream_.ProcessInternalEvent(ev_cfg1);
+                if (status)
+                    PAL_ERR(LOG_TAG, "Error:%d Failed to disconnect device %d", status,
+                                acd_stream_.GetAvailCaptureDevice());
             } else {
-              PAL_INFO(LOG_TAG,"no action needed, same capture profile");
+                std::shared_ptr<ACDEventConfig> ev_cfg1(
+                    new ACDDeviceConnectedEventConfig(acd_stream_.GetAvailCaptureDevice()));
+                status = acd_stream_.ProcessInternalEvent(ev_cfg1);
+                if (status)
+                    PAL_ERR(LOG_TAG, "Error:%d Failed to connect device %d", status, acd_stream_.GetAvailCaptureDevice());
             }
             break;
         }
@@ -1630,37 +1639,33 @@ int32_t StreamACD::ACDActive::ProcessEvent(
                 status = -EINVAL;
                 break;
             }
-            if (acd_stream_.cap_prof_ != new_cap_prof) {
-                PAL_DBG(LOG_TAG,
-                    "current capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
-                    acd_stream_.cap_prof_->GetName().c_str(),
-                    acd_stream_.cap_prof_->GetDevId(),
-                    acd_stream_.cap_prof_->GetChannels(),
-                    acd_stream_.cap_prof_->GetSampleRate(),
-                    acd_stream_.cap_prof_->isECRequired());
-                PAL_DBG(LOG_TAG,
-                    "new capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
-                    new_cap_prof->GetName().c_str(),
-                    new_cap_prof->GetDevId(),
-                    new_cap_prof->GetChannels(),
-                    new_cap_prof->GetSampleRate(),
-                    new_cap_prof->isECRequired());
-                if (!active) {
-                    std::shared_ptr<ACDEventConfig> ev_cfg1(
-                        new ACDDeviceDisconnectedEventConfig(acd_stream_.GetAvailCaptureDevice()));
-                    status = acd_stream_.ProcessInternalEvent(ev_cfg1);
-                    if (status)
-                        PAL_ERR(LOG_TAG, "Error:%d Failed to disconnect device %d", status,
-                                    acd_stream_.GetAvailCaptureDevice());
-                } else {
-                    std::shared_ptr<ACDEventConfig> ev_cfg1(
-                        new ACDDeviceConnectedEventConfig(acd_stream_.GetAvailCaptureDevice()));
-                    status = acd_stream_.ProcessInternalEvent(ev_cfg1);
-                    if (status)
-                        PAL_ERR(LOG_TAG, "Error:%d Failed to connect device %d", status, acd_stream_.GetAvailCaptureDevice());
-                }
+            PAL_DBG(LOG_TAG,
+                "current capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
+                acd_stream_.cap_prof_->GetName().c_str(),
+                acd_stream_.cap_prof_->GetDevId(),
+                acd_stream_.cap_prof_->GetChannels(),
+                acd_stream_.cap_prof_->GetSampleRate(),
+                acd_stream_.cap_prof_->isECRequired());
+            PAL_DBG(LOG_TAG,
+                "new capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
+                new_cap_prof->GetName().c_str(),
+                new_cap_prof->GetDevId(),
+                new_cap_prof->GetChannels(),
+                new_cap_prof->GetSampleRate(),
+                new_cap_prof->isECRequired());
+            if (!active) {
+                std::shared_ptr<ACDEventConfig> ev_cfg1(
+                    new ACDDeviceDisconnectedEventConfig(acd_stream_.GetAvailCaptureDevice()));
+                status = acd_stream_.ProcessInternalEvent(ev_cfg1);
+                if (status)
+                    PAL_ERR(LOG_TAG, "Error:%d Failed to disconnect device %d", status,
+                                acd_stream_.GetAvailCaptureDevice());
             } else {
-              PAL_INFO(LOG_TAG,"no action needed, same capture profile");
+                std::shared_ptr<ACDEventConfig> ev_cfg1(
+                    new ACDDeviceConnectedEventConfig(acd_stream_.GetAvailCaptureDevice()));
+                status = acd_stream_.ProcessInternalEvent(ev_cfg1);
+                if (status)
+                    PAL_ERR(LOG_TAG, "Error:%d Failed to connect device %d", status, acd_stream_.GetAvailCaptureDevice());
             }
             break;
         }
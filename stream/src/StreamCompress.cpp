@@ -46,21 +46,18 @@
 #define COMPRESS_OFFLOAD_FRAGMENT_SIZE (32 * 1024)
 #define COMPRESS_OFFLOAD_NUM_FRAGMENTS 4
 
-std::condition_variable cvPause;
-
 static void handleSessionCallBack(uint64_t hdl, uint32_t event_id, void *data,
                                   uint32_t event_size)
 {
-    Stream *s = NULL;
+    Stream *s = reinterpret_cast<Stream *>(hdl);
     pal_stream_callback cb;
 
     PAL_DBG(LOG_TAG,"Event id %x ", event_id);
     if (event_id == EVENT_ID_SOFT_PAUSE_PAUSE_COMPLETE) {
         PAL_DBG(LOG_TAG,"Pause Done");
-        cvPause.notify_all();
+        s->signalPauseDone();
     }
     else {
-        s = reinterpret_cast<Stream *>(hdl);
         if (s->getCallBack(&cb) == 0)
             cb(reinterpret_cast<pal_stream_handle_t *>(s), event_id, (uint32_t *)data,
                event_size, s->cookie);
@@ -746,9 +743,20 @@ int32_t StreamCompress::getCallBack(pal_stream_callback *cb)
     return 0;
 }
 
-int32_t StreamCompress::getParameters(uint32_t /*param_id*/, void ** /*payload*/)
+int32_t StreamCompress::getParameters(uint32_t param_id, void **payload)
 {
-    return 0;
+    pal_param_payload *pal_payload = nullptr;
+
+    if (param_id != PAL_PARAM_ID_TIMESTAMP_INFO)
+        return 0;
+
+    pal_payload = payload ? (pal_param_payload *)(*payload) : nullptr;
+    if (!pal_payload || pal_payload->payload_size != sizeof(pal_timestamp_info_t)) {
+        PAL_ERR(LOG_TAG, "Invalid timestamp info payload");
+        return -EINVAL;
+    }
+
+    return getTimestampInfo((pal_timestamp_info_t *)pal_payload->payload);
 }
 
 int32_t StreamCompress::setParameters(uint32_t param_id, void *payload)
@@ -957,6 +965,7 @@ int32_t StreamCompress::pause_l()
     if (isPaused) {
         PAL_INFO(LOG_TAG, "Stream is already paused");
     } else {
+        pauseDone = false;
         status = session->setConfig(this, MODULE, PAUSE_TAG);
         if (0 != status) {
             PAL_ERR(LOG_TAG,"session setConfig for pause failed with status %d",status);
@@ -964,7 +973,8 @@ int32_t StreamCompress::pause_l()
         }
         if (session->isPauseRegistrationDone) {
             PAL_DBG(LOG_TAG, "Waiting for Pause to complete from ADSP");
-            cvPause.wait_for(pauseLock, std::chrono::microseconds(VOLUME_RAMP_PERIOD));
+            if (!waitPauseDone(pauseLock, VOLUME_RAMP_PERIOD))
+                PAL_DBG(LOG_TAG, "Pause done event not received");
         } else {
             PAL_DBG(LOG_TAG, "Pause event registration not done, sleeping for %d",
                     VOLUME_RAMP_PERIOD);
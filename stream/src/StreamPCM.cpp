@@ -873,14 +873,14 @@ int32_t StreamPCM::setVolume(struct pal_volume_data *volume)
        goto exit;
     }
 
-    // if already allocated free and reallocate
-    if (mVolumeData) {
+    volSize = sizeof(uint32_t) + (sizeof(struct pal_channel_vol_kv) * (volume->no_of_volpair));
+    // reallocate only when the channel count changes
+    if (mVolumeData && mVolumeData->no_of_volpair != volume->no_of_volpair) {
         free(mVolumeData);
         mVolumeData = NULL;
     }
-
-    volSize = sizeof(uint32_t) + (sizeof(struct pal_channel_vol_kv) * (volume->no_of_volpair));
-    mVolumeData = (struct pal_volume_data *)calloc(1, volSize);
+    if (!mVolumeData)
+        mVolumeData = (struct pal_volume_data *)calloc(1, volSize);
     if (!mVolumeData) {
         status = -ENOMEM;
         PAL_ERR(LOG_TAG, "failed to calloc for volume data");
@@ -1079,7 +1079,9 @@ int32_t StreamPCM::write(struct pal_buffer* buf)
     // we should allow writes to go through in Start/Pause state as well.
     if ((currentState == STREAM_STARTED) ||
         (currentState == STREAM_PAUSED) ) {
+        beginTransfer_l();
         status = session->write(this, SHMEM_ENDPOINT, buf, &size, 0);
+        endTransfer_l();
         mStreamMutex.unlock();
         if (0 != status) {
             PAL_ERR(LOG_TAG, "session write is failed with status %d", status);
@@ -1140,9 +1142,20 @@ int32_t  StreamPCM::getCallBack(pal_stream_callback * /*cb*/)
     return 0;
 }
 
-int32_t StreamPCM::getParameters(uint32_t /*param_id*/, void ** /*payload*/)
+int32_t StreamPCM::getParameters(uint32_t param_id, void **payload)
 {
-    return 0;
+    pal_param_payload *pal_payload = nullptr;
+
+    if (param_id != PAL_PARAM_ID_TIMESTAMP_INFO)
+        return 0;
+
+    pal_payload = payload ? (pal_param_payload *)(*payload) : nullptr;
+    if (!pal_payload || pal_payload->payload_size != sizeof(pal_timestamp_info_t)) {
+        PAL_ERR(LOG_TAG, "Invalid timestamp info payload");
+        return -EINVAL;
+    }
+
+    return getTimestampInfo((pal_timestamp_info_t *)pal_payload->payload);
 }
 
 int32_t  StreamPCM::setParameters(uint32_t param_id, void *payload)
@@ -1255,6 +1268,29 @@ int32_t  StreamPCM::setParameters(uint32_t param_id, void *payload)
                        status);
             break;
         }
+        case PAL_PARAM_ID_VOICE_PREARM:
+        {
+            bool arm = false;
+            param_payload = (pal_param_payload *)payload;
+            if (mStreamAttr->type != PAL_STREAM_VOICE_CALL ||
+                param_payload->payload_size < sizeof(bool)) {
+                PAL_ERR(LOG_TAG, "voice prearm not supported for stream type %d",
+                        mStreamAttr->type);
+                status = -EINVAL;
+                break;
+            }
+            if (currentState != STREAM_INIT) {
+                PAL_ERR(LOG_TAG, "voice prearm in invalid state %d", currentState);
+                status = -EINVAL;
+                break;
+            }
+            arm = *((bool *)param_payload->payload);
+            status = arm ? session->prearm(this) : session->disarm(this);
+            if (status)
+               PAL_ERR(LOG_TAG, "voice %s failed with %d", arm ? "prearm" : "disarm",
+                       status);
+            break;
+        }
         default:
             PAL_ERR(LOG_TAG, "Unsupported param id %u", param_id);
             status = -EINVAL;
@@ -1323,6 +1359,7 @@ int32_t StreamPCM::pause_l()
     if (isPaused) {
         PAL_INFO(LOG_TAG, "Stream is already paused");
     } else {
+        pauseDone = false;
         status = session->setConfig(this, MODULE, PAUSE_TAG);
         if (0 != status) {
            PAL_ERR(LOG_TAG, "session setConfig for pause failed with status %d",
@@ -1331,7 +1368,8 @@ int32_t StreamPCM::pause_l()
         }
         if (session->isPauseRegistrationDone) {
             PAL_DBG(LOG_TAG, "Waiting for Pause to complete from ADSP");
-            pauseCV.wait_for(pauseLock, std::chrono::microseconds(VOLUME_RAMP_PERIOD));
+            if (!waitPauseDone(pauseLock, VOLUME_RAMP_PERIOD))
+                PAL_DBG(LOG_TAG, "Pause done event not received");
         } else {
             PAL_DBG(LOG_TAG, "Pause event registration not done, sleeping for %d",
                     VOLUME_RAMP_PERIOD);
@@ -536,43 +536,45 @@ int32_t StreamSensorPCMData::HandleConcurrentStream(bool active)
         return status;
     }
 
+    /* only called for a changed profile, see IsCaptureProfileChanged */
     new_cap_prof = GetCurrentCaptureProfile();
-    if (new_cap_prof && cap_prof_ != new_cap_prof) {
-        PAL_DBG(LOG_TAG,
-            "current capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
-            cap_prof_->GetName().c_str(),
-            cap_prof_->GetDevId(),
-            cap_prof_->GetChannels(),
-            cap_prof_->GetSampleRate(),
-            cap_prof_->isECRequired());
-        PAL_DBG(LOG_TAG,
-            "new capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
-            new_cap_prof->GetName().c_str(),
-            new_cap_prof->GetDevId(),
-            new_cap_prof->GetChannels(),
-            new_cap_prof->GetSampleRate(),
-            new_cap_prof->isECRequired());
-
-        if (!active) {
-            PAL_DBG(LOG_TAG, "disconnect device %d", GetAvailCaptureDevice());
-            /* disconnect the backend device */
-            status = DisconnectDevice_l(GetAvailCaptureDevice());
-            if (status)
-                PAL_ERR(LOG_TAG, "Error:%d Failed to disconnect device %d",
-                        status, GetAvailCaptureDevice());
-        } else {
-            /* store the pre-proc KV selected in the config file */
-            if (new_cap_prof)
-                mDevPPSelector = new_cap_prof->GetName();
-            /* connect the backend device */
-            PAL_DBG(LOG_TAG, "connect device %d", GetAvailCaptureDevice());
-            status = ConnectDevice_l(GetAvailCaptureDevice());
-            if (status)
-                PAL_ERR(LOG_TAG, "Error:%d Failed to connect device %d",
-                        status, GetAvailCaptureDevice());
-        }
+    if (!new_cap_prof) {
+        PAL_ERR(LOG_TAG, "Failed to get new capture profile");
+        if (active == true)
+            mStreamMutex.unlock();
+        return -EINVAL;
+    }
+    PAL_DBG(LOG_TAG,
+        "current capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
+        cap_prof_->GetName().c_str(),
+        cap_prof_->GetDevId(),
+        cap_prof_->GetChannels(),
+        cap_prof_->GetSampleRate(),
+        cap_prof_->isECRequired());
+    PAL_DBG(LOG_TAG,
+        "new capture profile %s: dev_id=0x%x, chs=%d, sr=%d, ec_ref=%d\n",
+        new_cap_prof->GetName().c_str(),
+        new_cap_prof->GetDevId(),
+        new_cap_prof->GetChannels(),
+        new_cap_prof->GetSampleRate(),
+        new_cap_prof->isECRequired());
+
+    if (!active) {
+        PAL_DBG(LOG_TAG, "disconnect device %d", GetAvailCaptureDevice());
+        /* disconnect the backend device */
+        status = DisconnectDevice_l(GetAvailCaptureDevice());
+        if (status)
+            PAL_ERR(LOG_TAG, "Error:%d Failed to disconnect device %d",
+                    status, GetAvailCaptureDevice());
     } else {
-      PAL_INFO(LOG_TAG, "no action needed, same capture profile");
+        /* store the pre-proc KV selected in the config file */
+        mDevPPSelector = new_cap_prof->GetName();
+        /* connect the backend device */
+        PAL_DBG(LOG_TAG, "connect device %d", GetAvailCaptureDevice());
+        status = ConnectDevice_l(GetAvailCaptureDevice());
+        if (status)
+            PAL_ERR(LOG_TAG, "Error:%d Failed to connect device %d",
+                    status, GetAvailCaptureDevice());
     }
 
     if (active == true)
@@ -582,6 +584,16 @@ int32_t StreamSensorPCMData::HandleConcurrentStream(bool active)
     return status;
 }
 
+bool StreamSensorPCMData::IsCaptureProfileChanged()
+{
+    std::lock_guard<std::mutex> lck(mStreamMutex);
+
+    if (currentState != STREAM_STARTED)
+        return false;
+
+    return IsCaptureProfileSwitch(cap_prof_, GetCurrentCaptureProfile());
+}
+
 int32_t StreamSensorPCMData::DisconnectDevice_l(pal_device_id_t device_id)
 {
     int32_t status = 0;
@@ -602,7 +602,6 @@ int32_t StreamSoundTrigger::setParameters(uint32_t param_id, void *payload) {
 int32_t StreamSoundTrigger::HandleConcurrentStream(bool active) {
     int32_t status = 0;
     uint64_t transit_duration = 0;
-    std::shared_ptr<CaptureProfile> new_cap_prof = nullptr;
 
     if (!active) {
         mStreamMutex.lock();
@@ -611,14 +610,10 @@ int32_t StreamSoundTrigger::HandleConcurrentStream(bool active) {
     }
 
     PAL_DBG(LOG_TAG, "Enter");
-    new_cap_prof = GetCurrentCaptureProfile();
-    if (cap_prof_ != new_cap_prof) {
-        std::shared_ptr<StEventConfig> ev_cfg(
-            new StConcurrentStreamEventConfig(active));
-        status = cur_state_->ProcessEvent(ev_cfg);
-    } else {
-        PAL_DBG(LOG_TAG, "Same capture pofile, no need to update");
-    }
+    /* only called for a changed profile, see IsCaptureProfileChanged */
+    std::shared_ptr<StEventConfig> ev_cfg(
+        new StConcurrentStreamEventConfig(active));
+    status = cur_state_->ProcessEvent(ev_cfg);
 
     if (active) {
         transit_end_time_ = std::chrono::steady_clock::now();
@@ -641,6 +636,12 @@ int32_t StreamSoundTrigger::HandleConcurrentStream(bool active) {
     return status;
 }
 
+bool StreamSoundTrigger::IsCaptureProfileChanged() {
+    std::lock_guard<std::mutex> lck(mStreamMutex);
+
+    return IsCaptureProfileSwitch(cap_prof_, GetCurrentCaptureProfile());
+}
+
 int32_t StreamSoundTrigger::setECRef(std::shared_ptr<Device> dev, bool is_enable) {
     int32_t status = 0;
 
@@ -914,6 +915,8 @@ void StreamSoundTrigger::InternalStopRecognition() {
 }
 
 void StreamSoundTrigger::TimerThread(StreamSoundTrigger& st_stream) {
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_EVENT, "pal_st_timer");
+
     PAL_DBG(LOG_TAG, "Enter");
 
     std::unique_lock<std::mutex> lck(st_stream.timer_mutex_);
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: VolumeScheduler"
+
+#include "VolumeScheduler.h"
+#include "Stream.h"
+#include "ResourceManager.h"
+
+#include <string.h>
+#include <system_error>
+#include <thread>
+
+VolumeScheduler* VolumeScheduler::getInstance()
+{
+    /* never destroyed, the detached worker may still reference it at exit */
+    static VolumeScheduler *instance = new VolumeScheduler();
+
+    return instance;
+}
+
+VolumeScheduler::VolumeScheduler()
+    : busy_(nullptr),
+      workerStarted_(false)
+{
+}
+
+bool VolumeScheduler::defer(Stream *s, const struct pal_volume_data *volume, uint64_t seq)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto window = std::chrono::milliseconds(VOLUME_COALESCE_WINDOW_MS);
+    size_t volSize = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!s || !volume || volume->no_of_volpair == 0)
+        return false;
+
+    auto it = entries_.find(s);
+    if (it == entries_.end() ||
+        (!it->second.hasPending && now - it->second.lastApplied >= window)) {
+        entries_[s].lastApplied = now;
+        return false;
+    }
+
+    if (!workerStarted_) {
+        try {
+            std::thread(workerLoop, this).detach();
+        } catch (const std::system_error &e) {
+            PAL_ERR(LOG_TAG, "failed to create volume worker: %s", e.what());
+            it->second.lastApplied = now;
+            return false;
+        }
+        workerStarted_ = true;
+    }
+
+    volSize = sizeof(uint32_t) + sizeof(struct pal_channel_vol_kv) * volume->no_of_volpair;
+    it->second.pending.assign((const uint8_t *)volume, (const uint8_t *)volume + volSize);
+    it->second.pendingSeq = seq;
+    if (!it->second.hasPending) {
+        it->second.hasPending = true;
+        workCv_.notify_one();
+    }
+    PAL_VERBOSE(LOG_TAG, "stream %pK volume %f coalesced", s, volume->volume_pair[0].vol);
+
+    return true;
+}
+
+void VolumeScheduler::cancel(Stream *s)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    entries_.erase(s);
+    busyCv_.wait(lock, [this, s] { return busy_ != s; });
+}
+
+void VolumeScheduler::apply(Stream *s, struct pal_volume_data *volume, uint64_t seq)
+{
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+    int32_t status = 0;
+
+    rm->lockActiveStream();
+    if (!rm->isActiveStream(reinterpret_cast<pal_stream_handle_t *>(s)) ||
+        rm->increaseStreamUserCounter(s)) {
+        rm->unlockActiveStream();
+        return;
+    }
+    rm->unlockActiveStream();
+
+    /* queued behind a blocking write rather than holding up other streams */
+    status = s->setVolumeOrdered(volume, seq);
+    if (status)
+        PAL_ERR(LOG_TAG, "stream %pK deferred volume %llu failed %d", s,
+                (unsigned long long)seq, status);
+
+    rm->lockActiveStream();
+    rm->decreaseStreamUserCounter(s);
+    rm->unlockActiveStream();
+}
+
+void VolumeScheduler::workerLoop(VolumeScheduler *sched)
+{
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_EVENT, "pal_volume");
+
+    auto window = std::chrono::milliseconds(VOLUME_COALESCE_WINDOW_MS);
+    std::vector<uint8_t> volume;
+    uint64_t seq = 0;
+    std::unique_lock<std::mutex> lock(sched->mutex_);
+
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        auto wakeAt = std::chrono::steady_clock::time_point::max();
+        Stream *due = nullptr;
+
+        for (auto &e : sched->entries_) {
+            if (!e.second.hasPending)
+                continue;
+            auto dueAt = e.second.lastApplied + window;
+            if (dueAt <= now) {
+                due = e.first;
+                break;
+            }
+            if (dueAt < wakeAt)
+                wakeAt = dueAt;
+        }
+
+        if (!due) {
+            if (wakeAt == std::chrono::steady_clock::time_point::max())
+                sched->workCv_.wait(lock);
+            else
+                sched->workCv_.wait_until(lock, wakeAt);
+            continue;
+        }
+
+        struct volume_sched_entry &entry = sched->entries_[due];
+        volume.swap(entry.pending);
+        seq = entry.pendingSeq;
+        entry.hasPending = false;
+        entry.lastApplied = now;
+        sched->busy_ = due;
+        lock.unlock();
+
+        apply(due, (struct pal_volume_data *)volume.data(), seq);
+
+        lock.lock();
+        sched->busy_ = nullptr;
+        sched->busyCv_.notify_all();
+    }
+}
@@ -0,0 +1,397 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: WarmStreamPool"
+
+#include "WarmStreamPool.h"
+#include "Stream.h"
+#include "Device.h"
+#include "USBAudio.h"
+#include "ResourceManager.h"
+#include <time.h>
+#include <chrono>
+
+std::mutex WarmStreamPool::mutex_;
+std::condition_variable WarmStreamPool::cv_;
+std::thread WarmStreamPool::poolThread_;
+std::vector<struct warm_stream_entry> WarmStreamPool::parked_;
+std::vector<struct warm_stream_entry> WarmStreamPool::rewarmQ_;
+uint32_t WarmStreamPool::poolSize_ = 0;
+uint32_t WarmStreamPool::idleTimeoutMs_ = PAL_WARM_STREAM_IDLE_TIMEOUT_MS;
+bool WarmStreamPool::invalidated_ = false;
+bool WarmStreamPool::exit_ = false;
+
+uint64_t WarmStreamPool::nowMs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void WarmStreamPool::setPoolSize(uint32_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    PAL_INFO(LOG_TAG, "warm stream pool size %u -> %u", poolSize_, size);
+    poolSize_ = size;
+    if (poolSize_ == 0 && !parked_.empty()) {
+        invalidated_ = true;
+        cv_.notify_all();
+    }
+}
+
+void WarmStreamPool::setIdleTimeout(uint32_t timeoutMs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    PAL_INFO(LOG_TAG, "warm stream idle timeout %u -> %u ms", idleTimeoutMs_, timeoutMs);
+    idleTimeoutMs_ = timeoutMs;
+    cv_.notify_all();
+}
+
+bool WarmStreamPool::isEligible(const struct pal_stream_attributes *sAttr,
+                                uint32_t noOfDevices, const struct pal_device *devices,
+                                uint32_t noOfModifiers)
+{
+    pal_device_id_t id;
+
+    if (!sAttr || !devices || noOfDevices != 1 || noOfModifiers)
+        return false;
+    if (sAttr->type != PAL_STREAM_LOW_LATENCY &&
+        sAttr->type != PAL_STREAM_ULTRA_LOW_LATENCY)
+        return false;
+    if (sAttr->direction != PAL_AUDIO_OUTPUT ||
+        (sAttr->flags & (PAL_STREAM_FLAG_MMAP_MASK | PAL_STREAM_FLAG_MMAP_NO_IRQ_MASK)))
+        return false;
+
+    /* BT and USB configs follow the connected sink, never reuse them */
+    id = devices[0].id;
+    if (ResourceManager::isBtDevice(id) || USB::isUSBOutDevice(id))
+        return false;
+
+    return true;
+}
+
+bool WarmStreamPool::isMatch(const struct warm_stream_entry &entry,
+                             const struct pal_stream_attributes *sAttr,
+                             const struct pal_device *dev)
+{
+    const struct pal_media_config *a = &entry.attr.out_media_config;
+    const struct pal_media_config *b = &sAttr->out_media_config;
+
+    return entry.attr.type == sAttr->type &&
+           entry.attr.flags == sAttr->flags &&
+           a->sample_rate == b->sample_rate &&
+           a->bit_width == b->bit_width &&
+           a->ch_info.channels == b->ch_info.channels &&
+           a->aud_fmt_id == b->aud_fmt_id &&
+           entry.dev.id == dev->id &&
+           !strncmp(entry.dev.custom_config.custom_key, dev->custom_config.custom_key,
+                    PAL_MAX_CUSTOM_KEY_SIZE);
+}
+
+/*
+ * Another stream may have moved the shared backend to a different config,
+ * or group/headset device config may apply now: reuse only if a cold open
+ * would configure the device the same way.
+ */
+bool WarmStreamPool::isDeviceConfigCurrent(const struct warm_stream_entry &entry,
+                                           struct pal_stream_attributes *sAttr)
+{
+    struct pal_device dev = {};
+
+    dev.id = entry.dev.id;
+    strlcpy(dev.custom_config.custom_key, entry.dev.custom_config.custom_key,
+            PAL_MAX_CUSTOM_KEY_SIZE);
+    if (Stream::resolveDeviceConfig(sAttr, &dev))
+        return false;
+
+    return dev.config.sample_rate == entry.dev.config.sample_rate &&
+           dev.config.bit_width == entry.dev.config.bit_width &&
+           dev.config.ch_info.channels == entry.dev.config.ch_info.channels &&
+           dev.config.aud_fmt_id == entry.dev.config.aud_fmt_id &&
+           !strncmp(dev.sndDevName, entry.dev.sndDevName, DEVICE_NAME_MAX_SIZE);
+}
+
+uint32_t WarmStreamPool::countForDevice_l(pal_device_id_t id)
+{
+    uint32_t count = 0;
+
+    for (auto &entry : parked_) {
+        if (entry.dev.id == id)
+            count++;
+    }
+
+    return count;
+}
+
+bool WarmStreamPool::canPark(Stream *s)
+{
+    struct pal_stream_attributes sAttr = {};
+    struct pal_device dAttr = {};
+    std::vector<std::shared_ptr<Device>> devices;
+    struct modifier_kv modifier = {};
+    uint32_t noOfModifiers = 0;
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (poolSize_ == 0 || !rm || rm->cardState != CARD_STATUS_ONLINE)
+        return false;
+    /* volume/mmap state is left behind in the graph, keep those out */
+    if (s->isMMap || s->mVolumeData)
+        return false;
+
+    s->getStreamAttributes(&sAttr);
+    s->getAssociatedDevices(devices);
+    s->getModifiers(&modifier, &noOfModifiers);
+    if (devices.size() != 1)
+        return false;
+    dAttr.id = (pal_device_id_t)devices[0]->getSndDeviceId();
+    if (!isEligible(&sAttr, 1, &dAttr, noOfModifiers))
+        return false;
+
+    return countForDevice_l(dAttr.id) < poolSize_;
+}
+
+/* stop a stream that is going to be parked, its graph stays open */
+int32_t WarmStreamPool::quiesce(Stream *s)
+{
+    stream_state_t state = s->getCurState();
+
+    if (state == STREAM_STARTED || state == STREAM_PAUSED)
+        return s->stop();
+
+    return 0;
+}
+
+/*
+ * Parked streams are taken out of the RM stream lists, so device switch,
+ * EC and concurrency handling never see them and stale client handles
+ * fail isActiveStream(). RM is called outside mutex_, RM paths may call
+ * invalidate() with their own locks held.
+ */
+bool WarmStreamPool::park(Stream *s)
+{
+    struct warm_stream_entry entry = {};
+    std::vector<std::shared_ptr<Device>> devices;
+    stream_state_t state = s->getCurState();
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+
+    if (state != STREAM_INIT && state != STREAM_STOPPED)
+        return false;
+
+    s->getAssociatedDevices(devices);
+    if (devices.size() != 1)
+        return false;
+    s->getStreamAttributes(&entry.attr);
+    devices[0]->getDeviceAttributes(&entry.dev, s);
+    entry.dev.id = (pal_device_id_t)devices[0]->getSndDeviceId();
+
+    rm->deregisterStream(s);
+    lock.lock();
+    if (poolSize_ == 0 || countForDevice_l(entry.dev.id) >= poolSize_) {
+        lock.unlock();
+        rm->registerStream(s);
+        return false;
+    }
+
+    s->registerCallBack(NULL, 0);
+    entry.stream = s;
+    entry.parkedAtMs = nowMs();
+    parked_.push_back(entry);
+    startThread_l();
+    cv_.notify_all();
+    PAL_DBG(LOG_TAG, "parked stream %pK on device %d, %zu parked",
+            s, entry.dev.id, parked_.size());
+
+    return true;
+}
+
+Stream* WarmStreamPool::acquire(struct pal_stream_attributes *sAttr, uint32_t noOfDevices,
+                                struct pal_device *devices, uint32_t noOfModifiers)
+{
+    Stream *s = NULL;
+    stream_state_t state;
+    struct warm_stream_entry entry = {};
+    std::vector<Stream *> stale;
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (poolSize_ == 0 || parked_.empty() || invalidated_ ||
+        !isEligible(sAttr, noOfDevices, devices, noOfModifiers))
+        return NULL;
+
+    for (auto it = parked_.begin(); it != parked_.end(); it++) {
+        if (!isMatch(*it, sAttr, &devices[0]))
+            continue;
+        /* SSR may have torn the graph down underneath, leave it to expire */
+        state = it->stream->getCurState();
+        if (state != STREAM_INIT && state != STREAM_STOPPED)
+            continue;
+
+        s = it->stream;
+        entry = *it;
+        parked_.erase(it);
+        break;
+    }
+    lock.unlock();
+
+    if (!s)
+        return NULL;
+
+    /* resolving takes RM locks, so it runs with the stream out of the pool */
+    if (!isDeviceConfigCurrent(entry, sAttr)) {
+        PAL_INFO(LOG_TAG, "warm stream %pK device %d config is stale, cold open",
+                 s, entry.dev.id);
+        stale.push_back(s);
+        closeStreams(stale);
+        return NULL;
+    }
+
+    lock.lock();
+    rewarmQ_.push_back(entry);
+    cv_.notify_all();
+    lock.unlock();
+    PAL_DBG(LOG_TAG, "reuse warm stream %pK on device %d", s, devices[0].id);
+
+    /* back in the RM lists before the client sees it, as after Stream::create */
+    rm->registerStream(s);
+
+    return s;
+}
+
+void WarmStreamPool::closeStreams(std::vector<Stream *> &streams)
+{
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+
+    for (auto s : streams) {
+        PAL_DBG(LOG_TAG, "closing warm stream %pK", s);
+        /* close and the destructor expect the stream to be registered */
+        rm->registerStream(s);
+        if (s->close() != 0)
+            PAL_ERR(LOG_TAG, "warm stream %pK close failed", s);
+        delete s;
+    }
+    streams.clear();
+}
+
+bool WarmStreamPool::flush()
+{
+    std::vector<Stream *> streams;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (auto &entry : parked_)
+        streams.push_back(entry.stream);
+    parked_.clear();
+    rewarmQ_.clear();
+    lock.unlock();
+
+    if (streams.empty())
+        return false;
+
+    closeStreams(streams);
+    return true;
+}
+
+void WarmStreamPool::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (parked_.empty() && rewarmQ_.empty())
+        return;
+    invalidated_ = true;
+    cv_.notify_all();
+}
+
+void WarmStreamPool::deinit()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    exit_ = true;
+    cv_.notify_all();
+    lock.unlock();
+    if (poolThread_.joinable())
+        poolThread_.join();
+    flush();
+
+    lock.lock();
+    exit_ = false;
+    invalidated_ = false;
+}
+
+void WarmStreamPool::startThread_l()
+{
+    if (poolThread_.joinable())
+        return;
+
+    poolThread_ = std::thread(poolThreadLoop);
+}
+
+void WarmStreamPool::poolThreadLoop()
+{
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_BACKGROUND, "pal_warm_pool");
+
+    std::vector<Stream *> toClose;
+    std::vector<struct warm_stream_entry> toWarm;
+    std::shared_ptr<ResourceManager> rm = ResourceManager::getInstance();
+    uint64_t now = 0, nextExpiry = 0;
+    Stream *s = NULL;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    PAL_DBG(LOG_TAG, "warm stream pool thread started");
+    while (!exit_) {
+        now = nowMs();
+        nextExpiry = 0;
+        for (auto it = parked_.begin(); it != parked_.end();) {
+            if (invalidated_ || poolSize_ == 0 ||
+                now - it->parkedAtMs >= idleTimeoutMs_) {
+                toClose.push_back(it->stream);
+                it = parked_.erase(it);
+                continue;
+            }
+            if (!nextExpiry || it->parkedAtMs + idleTimeoutMs_ < nextExpiry)
+                nextExpiry = it->parkedAtMs + idleTimeoutMs_;
+            it++;
+        }
+        if (invalidated_)
+            rewarmQ_.clear();
+        invalidated_ = false;
+        toWarm.swap(rewarmQ_);
+
+        if (toClose.empty() && toWarm.empty()) {
+            if (nextExpiry)
+                cv_.wait_for(lock, std::chrono::milliseconds(nextExpiry - now));
+            else
+                cv_.wait(lock);
+            continue;
+        }
+        lock.unlock();
+
+        closeStreams(toClose);
+        for (auto &entry : toWarm) {
+            if (!rm || rm->cardState != CARD_STATUS_ONLINE)
+                break;
+            try {
+                s = Stream::create(&entry.attr, &entry.dev, 1, NULL, 0);
+            } catch (const std::exception& e) {
+                PAL_ERR(LOG_TAG, "warm stream create failed: %s", e.what());
+                s = NULL;
+            }
+            if (!s)
+                continue;
+            if (s->open() != 0 || !park(s)) {
+                PAL_DBG(LOG_TAG, "dropping re-warmed stream %pK", s);
+                s->close();
+                delete s;
+            }
+        }
+        toWarm.clear();
+
+        lock.lock();
+    }
+    PAL_DBG(LOG_TAG, "warm stream pool thread exit");
+}
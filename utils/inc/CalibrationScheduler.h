@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef CALIBRATION_SCHEDULER_H
+#define CALIBRATION_SCHEDULER_H
+
+#include <time.h>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+
+/*
+ * Tracks active/idle transitions of a protected device (speaker, haptics)
+ * and lets the calibration thread sleep until the idle window has elapsed,
+ * instead of polling the in-use state periodically.
+ */
+class CalibrationScheduler {
+public:
+    CalibrationScheduler(const char *name, unsigned long minIdleSec);
+
+    void setMinIdleTime(unsigned long minIdleSec);
+    void setInUse(bool inUse);
+    bool isInUse(unsigned long *idleSec);
+    void restartIdleWindow();
+    void waitForIdleWindow(bool force);
+    void sleepFor(unsigned long ms);
+
+protected:
+    unsigned long getIdleTimeMs_l();
+
+    std::string name_;
+    unsigned long minIdleSec_;
+    bool inUse_;
+    struct timespec lastTimeUsed_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+#endif /* CALIBRATION_SCHEDULER_H */
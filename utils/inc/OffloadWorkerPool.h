@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef OFFLOAD_WORKER_POOL_H
+#define OFFLOAD_WORKER_POOL_H
+
+#include <stdint.h>
+#include <mutex>
+#include <condition_variable>
+
+#define OFFLOAD_TASK_MAX_CMDS     8
+#define OFFLOAD_POOL_MIN_WORKERS  1
+#define OFFLOAD_POOL_IDLE_TIMEOUT_MS 5000
+
+typedef void (*offload_cmd_handler)(void *cookie, int cmd);
+
+/*
+ * Per-client command slot embedded in the owner (e.g. a compress session).
+ * Commands are stored in a fixed ring, so posting never allocates.
+ */
+struct offload_task {
+    offload_cmd_handler handler = nullptr;
+    void *cookie = nullptr;
+    int cmds[OFFLOAD_TASK_MAX_CMDS];
+    uint32_t head = 0;
+    uint32_t count = 0;
+    bool attached = false;
+    bool detaching = false;
+    bool queued = false;
+    bool running = false;
+    offload_cmd_handler release = nullptr;
+    struct offload_task *next = nullptr;
+};
+
+/*
+ * Process wide pool of offload workers shared by all compress sessions and
+ * the asynchronous stream control API.
+ * Commands of one task run in post order and never concurrently; different
+ * tasks are served by whichever worker is free. Blocking compress ioctls
+ * (wait, drain) occupy a worker, so the pool grows on demand and keeps
+ * OFFLOAD_POOL_MIN_WORKERS threads alive once idle.
+ */
+class OffloadWorkerPool {
+public:
+    static OffloadWorkerPool* getInstance();
+
+    int attach(struct offload_task *task, offload_cmd_handler handler, void *cookie);
+    int post(struct offload_task *task, int cmd);
+    /*
+     * Last command of a task: later posts are rejected, and once it has run
+     * the task is detached and release(cookie, cmd) is called, after which
+     * the owner may free the task.
+     */
+    int postFinal(struct offload_task *task, int cmd, offload_cmd_handler release);
+    /* waits until all commands posted so far have run */
+    void waitIdle(struct offload_task *task);
+    /* runs commands already posted, then waits until the task is idle */
+    void detach(struct offload_task *task);
+
+protected:
+    OffloadWorkerPool();
+    static void workerLoop(OffloadWorkerPool *pool);
+    int spawnWorker_l();
+    int post_l(struct offload_task *task, int cmd);
+    void enqueue_l(struct offload_task *task, bool wakeWorker);
+
+    std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable idleCv_;
+    struct offload_task *readyHead_;
+    struct offload_task *readyTail_;
+    uint32_t numWorkers_;
+    uint32_t idleWorkers_;
+    uint32_t numReady_;
+};
+
+#endif /* OFFLOAD_WORKER_POOL_H */
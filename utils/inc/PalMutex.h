@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef PAL_MUTEX_H
+#define PAL_MUTEX_H
+
+#include <stdint.h>
+#include <mutex>
+
+#define PAL_MUTEX_MAX_CHECKED 32
+
+/*
+ * std::mutex with a name, usable with std::lock_guard/std::unique_lock.
+ *
+ * When built with PAL_LOCK_ORDER_CHECK, each PalMutex records the thread
+ * that owns it (up to PAL_MUTEX_MAX_CHECKED instances are tracked), and
+ * every blocking lock() records which other PalMutexes the calling thread
+ * owns at that point. Ownership lives in the mutex rather than the thread,
+ * as some RM locks are released by a different thread than the one that
+ * took them. The first time two locks are seen taken in opposite orders
+ * the inversion is logged with both names, so potential deadlocks show up
+ * in debug runs without having to hit them. try_lock() cannot deadlock and
+ * is tracked but never reported.
+ */
+class PalMutex {
+public:
+    explicit PalMutex(const char *name);
+    PalMutex(const PalMutex &) = delete;
+    PalMutex &operator=(const PalMutex &) = delete;
+
+#ifdef PAL_LOCK_ORDER_CHECK
+    void lock();
+    void unlock();
+    bool try_lock();
+#else
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+    bool try_lock() { return mutex_.try_lock(); }
+#endif
+    const char *name() const { return name_; }
+
+private:
+    std::mutex mutex_;
+    const char *name_;
+#ifdef PAL_LOCK_ORDER_CHECK
+    uint32_t id_;
+    void checkOrder();
+#endif
+};
+
+#endif /* PAL_MUTEX_H */
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef POWER_VOTE_H
+#define POWER_VOTE_H
+
+#include <stdint.h>
+#include <chrono>
+#include <mutex>
+
+#define PAL_POWER_VOTE_HOLD_MS 100
+
+/* issues the vote (on) or removes it (off), returns 0 or a negative errno */
+typedef int (*power_vote_apply)(void *cookie, bool on);
+
+struct power_vote_stats {
+    uint64_t votes;
+    uint64_t unvotes;
+    uint64_t applied;   /* apply calls, i.e. syscalls issued */
+    uint64_t absorbed;  /* releases cancelled by a new vote within the hold time */
+};
+
+/*
+ * Reference counted vote for a power resource (wakelock, ADSP sleep monitor
+ * activity). The vote is applied on the first vote() and removed holdMs
+ * after the count drops to zero, so vote/unvote bursts shorter than the
+ * hold time cost no syscalls. Pending releases are run by a shared timer
+ * thread; a zero hold time releases synchronously.
+ */
+class PowerVote {
+public:
+    PowerVote(const char *name, power_vote_apply apply, void *cookie, uint32_t holdMs);
+    /* runs a pending release before returning */
+    ~PowerVote();
+    PowerVote(const PowerVote &) = delete;
+    PowerVote &operator=(const PowerVote &) = delete;
+
+    int vote();
+    int unvote();
+    int32_t getCount();
+    void getStats(struct power_vote_stats *stats);
+    const char *name() const { return name_; }
+
+private:
+    friend class PowerVoteTimer;
+    typedef std::chrono::steady_clock::time_point time_point;
+
+    /* runs the release if due, returns the pending deadline or max() */
+    time_point expire(time_point now);
+    int apply_l(bool on);
+
+    std::mutex mutex_;
+    const char *name_;
+    power_vote_apply apply_;
+    void *cookie_;
+    std::chrono::milliseconds hold_;
+    int32_t count_;
+    bool applied_;
+    bool releasePending_;
+    time_point releaseAt_;
+    struct power_vote_stats stats_;
+};
+
+#endif /* POWER_VOTE_H */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef THREAD_POLICY_H
+#define THREAD_POLICY_H
+
+#include "PalDefs.h"
+#include <stdint.h>
+#include <sys/types.h>
+#include <map>
+#include <mutex>
+#include <vector>
+
+typedef enum {
+    PAL_THREAD_CLASS_CAPTURE = 0,   /* detection and LAB buffering */
+    PAL_THREAD_CLASS_OFFLOAD,       /* compress offload wait/drain workers */
+    PAL_THREAD_CLASS_EVENT,         /* mixer, engine and stream event dispatch, timers */
+    PAL_THREAD_CLASS_BACKGROUND,    /* SSR, card monitor, calibration, pools */
+    PAL_THREAD_CLASS_MAX,
+} pal_thread_class_t;
+
+struct thread_class_policy {
+    int schedPolicy;    /* SCHED_OTHER, SCHED_FIFO or SCHED_RR */
+    int rtPriority;     /* SCHED_FIFO/SCHED_RR only */
+    int nice;           /* SCHED_OTHER only */
+    uint64_t cpuMask;   /* bit n allows cpu n, 0 leaves affinity untouched */
+};
+
+struct thread_policy_entry {
+    pal_thread_class_t cls;
+    char name[PAL_THREAD_NAME_LEN];
+};
+
+/*
+ * Scheduling policy per class of PAL owned thread, set with <thread_policy>
+ * tags in the resource manager XML. A thread calls apply() first thing in
+ * its entry function: it is named, gets its class policy and is tracked
+ * until it exits, so a later XML update also reaches running threads.
+ * Failing to raise a priority (e.g. no CAP_SYS_NICE) is logged, not fatal.
+ */
+class ThreadPolicy {
+public:
+    static ThreadPolicy* getInstance();
+
+    void apply(pal_thread_class_t cls, const char *name);
+    /* attributes of one <thread_policy> tag */
+    void configure(const char **attr);
+    /* effective policy of every tracked thread, as reported by the kernel */
+    void query(std::vector<pal_thread_policy_info_t> &info);
+
+protected:
+    struct ExitGuard;
+
+    ThreadPolicy();
+    void applyTo(pid_t tid, pal_thread_class_t cls);
+    void untrack(pid_t tid);
+
+    std::mutex mutex_;
+    struct thread_class_policy policies_[PAL_THREAD_CLASS_MAX];
+    std::map<pid_t, struct thread_policy_entry> threads_;
+};
+
+#endif /* THREAD_POLICY_H */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef TIMER_SCHEDULER_H
+#define TIMER_SCHEDULER_H
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+typedef void (*timer_handler)(void *cookie);
+
+struct timer_entry {
+    uint64_t id;
+    timer_handler handler;
+    void *cookie;
+};
+
+/*
+ * Process wide one-shot timers on a monotonic clock, run in deadline order
+ * by a single thread. Handlers run with no scheduler lock held and must
+ * take the locks they need and revalidate state themselves, since anything
+ * may have changed since the action was scheduled.
+ */
+class TimerScheduler {
+public:
+    static TimerScheduler* getInstance();
+
+    /* returns a non-zero timer id, or 0 if the timer thread is unavailable */
+    uint64_t schedule(uint32_t delayMs, timer_handler handler, void *cookie);
+    /*
+     * Returns true if the timer was removed before it ran. Never waits for
+     * a handler already running, so it is safe to call with locks held that
+     * the handler takes.
+     */
+    bool cancel(uint64_t id);
+    /*
+     * Like cancel, but if the handler is already running waits for it to
+     * return. Use it before freeing state the handler references; the caller
+     * must not hold any lock the handler takes, nor call it from a handler.
+     */
+    bool cancelSync(uint64_t id);
+    /* cancels *id if set, then schedules a replacement and stores its id */
+    void reschedule(uint64_t *id, uint32_t delayMs, timer_handler handler, void *cookie);
+
+protected:
+    TimerScheduler();
+    static void timerLoop(TimerScheduler *sched);
+
+    typedef std::chrono::steady_clock::time_point time_point;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable doneCv_;
+    std::multimap<time_point, struct timer_entry> timers_;
+    uint64_t nextId_;
+    uint64_t runningId_;
+    bool started_;
+};
+
+#endif /* TIMER_SCHEDULER_H */
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: CalibrationScheduler"
+
+#include "CalibrationScheduler.h"
+#include "PalCommon.h"
+
+#include <chrono>
+
+CalibrationScheduler::CalibrationScheduler(const char *name, unsigned long minIdleSec)
+    : name_(name),
+      minIdleSec_(minIdleSec),
+      inUse_(false)
+{
+    clock_gettime(CLOCK_BOOTTIME, &lastTimeUsed_);
+}
+
+void CalibrationScheduler::setMinIdleTime(unsigned long minIdleSec)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    minIdleSec_ = minIdleSec;
+    cv_.notify_all();
+}
+
+/* Called on every active <-> idle transition of the device */
+void CalibrationScheduler::setInUse(bool inUse)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    inUse_ = inUse;
+    if (!inUse) {
+        clock_gettime(CLOCK_BOOTTIME, &lastTimeUsed_);
+        PAL_INFO(LOG_TAG, "%s used last time %ld", name_.c_str(), lastTimeUsed_.tv_sec);
+    }
+    cv_.notify_all();
+}
+
+bool CalibrationScheduler::isInUse(unsigned long *idleSec)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (idleSec)
+        *idleSec = inUse_ ? 0 : getIdleTimeMs_l() / 1000;
+    return inUse_;
+}
+
+/* Postpones the next calibration attempt by a full idle window */
+void CalibrationScheduler::restartIdleWindow()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    clock_gettime(CLOCK_BOOTTIME, &lastTimeUsed_);
+}
+
+unsigned long CalibrationScheduler::getIdleTimeMs_l()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    return (now.tv_sec - lastTimeUsed_.tv_sec) * 1000 +
+           (now.tv_nsec - lastTimeUsed_.tv_nsec) / 1000000;
+}
+
+/*
+ * Blocks until the device has been idle for the minimum idle time, or right
+ * away when it is idle and force is set. While the device is in use the
+ * thread sleeps without timeout and is woken by setInUse(false); while idle
+ * it sleeps until the idle deadline.
+ */
+void CalibrationScheduler::waitForIdleWindow(bool force)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    unsigned long idleMs = 0;
+
+    while (true) {
+        if (inUse_) {
+            PAL_DBG(LOG_TAG, "%s in use, wait for idle transition", name_.c_str());
+            cv_.wait(lock);
+            continue;
+        }
+
+        idleMs = getIdleTimeMs_l();
+        if (force || idleMs >= minIdleSec_ * 1000) {
+            PAL_DBG(LOG_TAG, "%s idle for %lu ms", name_.c_str(), idleMs);
+            return;
+        }
+
+        /*
+         * The deadline is re-evaluated against CLOCK_BOOTTIME after every
+         * wakeup since the condition variable clock stops in suspend.
+         */
+        PAL_DBG(LOG_TAG, "%s idle for %lu ms, wait %lu ms more", name_.c_str(),
+                idleMs, minIdleSec_ * 1000 - idleMs);
+        cv_.wait_for(lock, std::chrono::milliseconds(minIdleSec_ * 1000 - idleMs));
+    }
+}
+
+/* Retry delay that still tracks in-use transitions for the idle window */
+void CalibrationScheduler::sleepFor(unsigned long ms)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    cv_.wait_for(lock, std::chrono::milliseconds(ms));
+}
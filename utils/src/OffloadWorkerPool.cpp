@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: OffloadWorkerPool"
+
+#include "OffloadWorkerPool.h"
+#include "PalCommon.h"
+#include "ThreadPolicy.h"
+
+#include <errno.h>
+#include <chrono>
+#include <system_error>
+#include <thread>
+
+OffloadWorkerPool* OffloadWorkerPool::getInstance()
+{
+    /* never destroyed, detached workers may still reference it at exit */
+    static OffloadWorkerPool *instance = new OffloadWorkerPool();
+
+    return instance;
+}
+
+OffloadWorkerPool::OffloadWorkerPool()
+    : readyHead_(nullptr),
+      readyTail_(nullptr),
+      numWorkers_(0),
+      idleWorkers_(0),
+      numReady_(0)
+{
+}
+
+int OffloadWorkerPool::spawnWorker_l()
+{
+    try {
+        std::thread(workerLoop, this).detach();
+    } catch (const std::system_error &e) {
+        PAL_ERR(LOG_TAG, "failed to create offload worker: %s", e.what());
+        return -ENOMEM;
+    }
+    numWorkers_++;
+    PAL_DBG(LOG_TAG, "offload workers %u", numWorkers_);
+
+    return 0;
+}
+
+void OffloadWorkerPool::enqueue_l(struct offload_task *task, bool wakeWorker)
+{
+    task->next = nullptr;
+    task->queued = true;
+    if (readyTail_)
+        readyTail_->next = task;
+    else
+        readyHead_ = task;
+    readyTail_ = task;
+    numReady_++;
+
+    if (!wakeWorker)
+        return;
+
+    /* every idle worker is already spoken for, grow the pool */
+    if (numReady_ > idleWorkers_ && spawnWorker_l() == 0)
+        return;
+
+    workCv_.notify_one();
+}
+
+int OffloadWorkerPool::attach(struct offload_task *task, offload_cmd_handler handler,
+                              void *cookie)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!task || !handler) {
+        PAL_ERR(LOG_TAG, "invalid task or handler");
+        return -EINVAL;
+    }
+    if (task->attached) {
+        PAL_DBG(LOG_TAG, "task already attached");
+        return 0;
+    }
+    if (numWorkers_ == 0 && spawnWorker_l() != 0)
+        return -ENOMEM;
+
+    task->handler = handler;
+    task->cookie = cookie;
+    task->head = 0;
+    task->count = 0;
+    task->queued = false;
+    task->running = false;
+    task->detaching = false;
+    task->release = nullptr;
+    task->next = nullptr;
+    task->attached = true;
+
+    return 0;
+}
+
+int OffloadWorkerPool::post_l(struct offload_task *task, int cmd)
+{
+    if (!task->attached || task->detaching) {
+        PAL_ERR(LOG_TAG, "task not attached, drop cmd %d", cmd);
+        return -EINVAL;
+    }
+    if (task->count == OFFLOAD_TASK_MAX_CMDS) {
+        PAL_ERR(LOG_TAG, "task queue full, drop cmd %d", cmd);
+        return -ENOSPC;
+    }
+    task->cmds[(task->head + task->count) % OFFLOAD_TASK_MAX_CMDS] = cmd;
+    task->count++;
+
+    /* a running task is requeued by its worker to keep commands ordered */
+    if (!task->queued && !task->running)
+        enqueue_l(task, true);
+
+    return 0;
+}
+
+int OffloadWorkerPool::post(struct offload_task *task, int cmd)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return post_l(task, cmd);
+}
+
+int OffloadWorkerPool::postFinal(struct offload_task *task, int cmd,
+                                 offload_cmd_handler release)
+{
+    int ret = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ret = post_l(task, cmd);
+    if (ret)
+        return ret;
+
+    task->release = release;
+    task->detaching = true;
+
+    return 0;
+}
+
+void OffloadWorkerPool::waitIdle(struct offload_task *task)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    idleCv_.wait(lock, [task] {
+        return !task->attached ||
+               (task->count == 0 && !task->running && !task->queued);
+    });
+}
+
+void OffloadWorkerPool::detach(struct offload_task *task)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!task->attached)
+        return;
+
+    task->detaching = true;
+    idleCv_.wait(lock, [task] {
+        return task->count == 0 && !task->running && !task->queued;
+    });
+    task->attached = false;
+    task->detaching = false;
+    task->handler = nullptr;
+    task->cookie = nullptr;
+}
+
+void OffloadWorkerPool::workerLoop(OffloadWorkerPool *pool)
+{
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_OFFLOAD, "pal_offload");
+
+    struct offload_task *task = nullptr;
+    int cmd = 0;
+    bool ready = false;
+    std::unique_lock<std::mutex> lock(pool->mutex_);
+
+    while (1) {
+        if (!pool->readyHead_) {
+            pool->idleWorkers_++;
+            ready = pool->workCv_.wait_for(lock,
+                        std::chrono::milliseconds(OFFLOAD_POOL_IDLE_TIMEOUT_MS),
+                        [pool] { return pool->readyHead_ != nullptr; });
+            pool->idleWorkers_--;
+            if (!ready) {
+                if (pool->numWorkers_ > OFFLOAD_POOL_MIN_WORKERS)
+                    break;
+                continue;
+            }
+        }
+
+        task = pool->readyHead_;
+        pool->readyHead_ = task->next;
+        if (!pool->readyHead_)
+            pool->readyTail_ = nullptr;
+        pool->numReady_--;
+        task->next = nullptr;
+        task->queued = false;
+
+        /* one command per turn so a blocked drain cannot starve other tasks */
+        cmd = task->cmds[task->head];
+        task->head = (task->head + 1) % OFFLOAD_TASK_MAX_CMDS;
+        task->count--;
+        task->running = true;
+        lock.unlock();
+
+        task->handler(task->cookie, cmd);
+
+        lock.lock();
+        task->running = false;
+        /* picked up again by this worker, no need to wake another one */
+        if (task->count) {
+            pool->enqueue_l(task, false);
+        } else if (task->release) {
+            offload_cmd_handler release = task->release;
+            void *cookie = task->cookie;
+
+            /* the owner may free the task from release, do not touch it after */
+            task->release = nullptr;
+            task->handler = nullptr;
+            task->cookie = nullptr;
+            task->detaching = false;
+            task->attached = false;
+            pool->idleCv_.notify_all();
+            lock.unlock();
+            release(cookie, cmd);
+            lock.lock();
+        } else {
+            pool->idleCv_.notify_all();
+        }
+    }
+
+    pool->numWorkers_--;
+    PAL_DBG(LOG_TAG, "offload worker exit, %u left", pool->numWorkers_);
+}
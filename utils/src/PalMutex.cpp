@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: PalMutex"
+
+#include "PalMutex.h"
+#include "PalCommon.h"
+
+#ifdef PAL_LOCK_ORDER_CHECK
+#include <atomic>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define PAL_MUTEX_UNCHECKED PAL_MUTEX_MAX_CHECKED
+
+static std::atomic<uint32_t> nextId(0);
+static const char *lockNames[PAL_MUTEX_MAX_CHECKED];
+/* heldBefore[m] bit h: lock h was held at some point while m was taken */
+static std::atomic<uint32_t> heldBefore[PAL_MUTEX_MAX_CHECKED];
+static std::atomic<uint32_t> reported[PAL_MUTEX_MAX_CHECKED];
+/* tid of the thread that last took lock m, 0 while it is free */
+static std::atomic<pid_t> owners[PAL_MUTEX_MAX_CHECKED];
+
+static pid_t selfTid()
+{
+    static thread_local pid_t tid = 0;
+
+    if (!tid)
+        tid = (pid_t)syscall(SYS_gettid);
+    return tid;
+}
+
+/* locks currently owned by the calling thread */
+static uint32_t heldByCaller()
+{
+    pid_t self = selfTid();
+    uint32_t held = 0;
+
+    for (uint32_t h = 0; h < PAL_MUTEX_MAX_CHECKED; h++) {
+        if (owners[h].load(std::memory_order_relaxed) == self)
+            held |= 1u << h;
+    }
+    return held;
+}
+
+PalMutex::PalMutex(const char *name) : name_(name)
+{
+    id_ = nextId++;
+    if (id_ >= PAL_MUTEX_MAX_CHECKED) {
+        id_ = PAL_MUTEX_UNCHECKED;
+        return;
+    }
+    lockNames[id_] = name;
+}
+
+void PalMutex::checkOrder()
+{
+    uint32_t held = 0;
+    uint32_t inverted = 0;
+
+    if (id_ == PAL_MUTEX_UNCHECKED)
+        return;
+    held = heldByCaller();
+    if (!held)
+        return;
+
+    /* locks we hold that were previously seen taken after us */
+    for (uint32_t h = 0; h < PAL_MUTEX_MAX_CHECKED; h++) {
+        if ((held & (1u << h)) && (heldBefore[h].load() & (1u << id_)))
+            inverted |= 1u << h;
+    }
+    inverted &= ~reported[id_].fetch_or(inverted);
+    for (uint32_t h = 0; h < PAL_MUTEX_MAX_CHECKED; h++) {
+        if (inverted & (1u << h))
+            PAL_ERR(LOG_TAG, "lock order inversion: %s taken while holding %s, "
+                    "opposite order seen before", name_, lockNames[h]);
+    }
+    heldBefore[id_].fetch_or(held);
+}
+
+void PalMutex::lock()
+{
+    /* check before blocking, an inversion may be about to deadlock */
+    checkOrder();
+    mutex_.lock();
+    if (id_ != PAL_MUTEX_UNCHECKED)
+        owners[id_].store(selfTid(), std::memory_order_relaxed);
+}
+
+bool PalMutex::try_lock()
+{
+    if (!mutex_.try_lock())
+        return false;
+    if (id_ != PAL_MUTEX_UNCHECKED)
+        owners[id_].store(selfTid(), std::memory_order_relaxed);
+    return true;
+}
+
+void PalMutex::unlock()
+{
+    /* may run on another thread than lock(), ownership ends either way */
+    if (id_ != PAL_MUTEX_UNCHECKED)
+        owners[id_].store(0, std::memory_order_relaxed);
+    mutex_.unlock();
+}
+#else
+PalMutex::PalMutex(const char *name) : name_(name)
+{
+}
+#endif
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: PowerVote"
+
+#include "PowerVote.h"
+#include "PalCommon.h"
+#include "ThreadPolicy.h"
+
+#include <errno.h>
+#include <algorithm>
+#include <condition_variable>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/* single thread running the delayed releases of all PowerVotes */
+class PowerVoteTimer {
+public:
+    static PowerVoteTimer* getInstance()
+    {
+        /* never destroyed, the detached thread may still reference it at exit */
+        static PowerVoteTimer *instance = new PowerVoteTimer();
+
+        return instance;
+    }
+
+    void add(PowerVote *v)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        votes_.push_back(v);
+    }
+
+    void remove(PowerVote *v)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        votes_.erase(std::remove(votes_.begin(), votes_.end(), v), votes_.end());
+    }
+
+    /* called without the vote's lock held after scheduling a release */
+    void kick()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!started_) {
+            try {
+                std::thread(loop, this).detach();
+            } catch (const std::system_error &e) {
+                PAL_ERR(LOG_TAG, "failed to create power vote timer: %s", e.what());
+                return;
+            }
+            started_ = true;
+        }
+        cv_.notify_one();
+    }
+
+private:
+    PowerVoteTimer() : started_(false) {}
+
+    static void loop(PowerVoteTimer *timer)
+    {
+        ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_EVENT, "pal_power_vote");
+
+        std::unique_lock<std::mutex> lock(timer->mutex_);
+
+        while (true) {
+            auto now = std::chrono::steady_clock::now();
+            auto wakeAt = std::chrono::steady_clock::time_point::max();
+
+            for (PowerVote *v : timer->votes_)
+                wakeAt = std::min(wakeAt, v->expire(now));
+
+            if (wakeAt == std::chrono::steady_clock::time_point::max())
+                timer->cv_.wait(lock);
+            else
+                timer->cv_.wait_until(lock, wakeAt);
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<PowerVote *> votes_;
+    bool started_;
+};
+
+PowerVote::PowerVote(const char *name, power_vote_apply apply, void *cookie, uint32_t holdMs)
+    : name_(name),
+      apply_(apply),
+      cookie_(cookie),
+      hold_(holdMs),
+      count_(0),
+      applied_(false),
+      releasePending_(false),
+      stats_{}
+{
+    PowerVoteTimer::getInstance()->add(this);
+}
+
+PowerVote::~PowerVote()
+{
+    PowerVoteTimer::getInstance()->remove(this);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (applied_ && count_ == 0)
+        apply_l(false);
+    PAL_INFO(LOG_TAG, "%s: votes %llu unvotes %llu applied %llu absorbed %llu", name_,
+             (unsigned long long)stats_.votes, (unsigned long long)stats_.unvotes,
+             (unsigned long long)stats_.applied, (unsigned long long)stats_.absorbed);
+}
+
+int PowerVote::apply_l(bool on)
+{
+    int ret = apply_(cookie_, on);
+
+    stats_.applied++;
+    if (ret) {
+        PAL_ERR(LOG_TAG, "%s: failed to %s, ret %d", name_, on ? "vote" : "unvote", ret);
+        return ret;
+    }
+    applied_ = on;
+    PAL_DBG(LOG_TAG, "%s: %s, count %d", name_, on ? "voted" : "unvoted", count_);
+
+    return 0;
+}
+
+int PowerVote::vote()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    stats_.votes++;
+    count_++;
+    if (releasePending_) {
+        releasePending_ = false;
+        stats_.absorbed++;
+    }
+    if (applied_)
+        return 0;
+
+    return apply_l(true);
+}
+
+int PowerVote::unvote()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (count_ == 0) {
+            PAL_ERR(LOG_TAG, "%s: unvote without vote", name_);
+            return 0;
+        }
+        stats_.unvotes++;
+        if (--count_ > 0 || !applied_)
+            return 0;
+
+        if (hold_.count() == 0)
+            return apply_l(false);
+
+        releasePending_ = true;
+        releaseAt_ = std::chrono::steady_clock::now() + hold_;
+    }
+    PowerVoteTimer::getInstance()->kick();
+
+    return 0;
+}
+
+PowerVote::time_point PowerVote::expire(time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!releasePending_)
+        return time_point::max();
+    if (now < releaseAt_)
+        return releaseAt_;
+
+    releasePending_ = false;
+    if (count_ == 0 && applied_)
+        apply_l(false);
+
+    return time_point::max();
+}
+
+int32_t PowerVote::getCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return count_;
+}
+
+void PowerVote::getStats(struct power_vote_stats *stats)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    *stats = stats_;
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: ThreadPolicy"
+
+#include "ThreadPolicy.h"
+#include "PalCommon.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* same as ANDROID_PRIORITY_AUDIO */
+#define PAL_THREAD_NICE_AUDIO -16
+#define PAL_THREAD_NICE_EVENT -8
+
+static const char *threadClassNames[PAL_THREAD_CLASS_MAX] = {
+    "capture",
+    "offload",
+    "event",
+    "background",
+};
+
+/* drops the thread from the tracked set when it exits */
+struct ThreadPolicy::ExitGuard {
+    pid_t tid = 0;
+    ~ExitGuard()
+    {
+        if (tid)
+            ThreadPolicy::getInstance()->untrack(tid);
+    }
+};
+
+static pid_t currentTid()
+{
+    return (pid_t)syscall(SYS_gettid);
+}
+
+/* "0-3,6" -> 0x4f, returns 0 on a malformed list */
+static uint64_t parseCpuList(const char *list)
+{
+    uint64_t mask = 0;
+    char *end = nullptr;
+    long first = 0, last = 0;
+
+    while (*list) {
+        first = strtol(list, &end, 10);
+        if (end == list || first < 0 || first >= 64)
+            return 0;
+        last = first;
+        list = end;
+        if (*list == '-') {
+            last = strtol(list + 1, &end, 10);
+            if (end == list + 1 || last < first || last >= 64)
+                return 0;
+            list = end;
+        }
+        for (long cpu = first; cpu <= last; cpu++)
+            mask |= 1ULL << cpu;
+        if (*list == ',')
+            list++;
+        else if (*list)
+            return 0;
+    }
+
+    return mask;
+}
+
+ThreadPolicy* ThreadPolicy::getInstance()
+{
+    /* never destroyed, detached threads may still exit after static teardown */
+    static ThreadPolicy *instance = new ThreadPolicy();
+
+    return instance;
+}
+
+ThreadPolicy::ThreadPolicy()
+{
+    policies_[PAL_THREAD_CLASS_CAPTURE] = {SCHED_OTHER, 0, PAL_THREAD_NICE_AUDIO, 0};
+    policies_[PAL_THREAD_CLASS_OFFLOAD] = {SCHED_OTHER, 0, PAL_THREAD_NICE_AUDIO, 0};
+    policies_[PAL_THREAD_CLASS_EVENT] = {SCHED_OTHER, 0, PAL_THREAD_NICE_EVENT, 0};
+    policies_[PAL_THREAD_CLASS_BACKGROUND] = {SCHED_OTHER, 0, 0, 0};
+}
+
+void ThreadPolicy::applyTo(pid_t tid, pal_thread_class_t cls)
+{
+    const struct thread_class_policy &policy = policies_[cls];
+    struct sched_param param;
+    cpu_set_t cpus;
+
+    memset(&param, 0, sizeof(param));
+    if (policy.schedPolicy != SCHED_OTHER)
+        param.sched_priority = policy.rtPriority;
+    /* also moves a thread created by an RT caller back to SCHED_OTHER */
+    if (sched_setscheduler(tid, policy.schedPolicy, &param))
+        PAL_INFO(LOG_TAG, "tid %d: sched policy %d prio %d not applied, errno %d",
+                 tid, policy.schedPolicy, param.sched_priority, errno);
+
+    if (policy.schedPolicy == SCHED_OTHER &&
+        setpriority(PRIO_PROCESS, tid, policy.nice))
+        PAL_INFO(LOG_TAG, "tid %d: nice %d not applied, errno %d", tid, policy.nice, errno);
+
+    if (policy.cpuMask) {
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+            if (policy.cpuMask & (1ULL << cpu))
+                CPU_SET(cpu, &cpus);
+        }
+        if (sched_setaffinity(tid, sizeof(cpus), &cpus))
+            PAL_INFO(LOG_TAG, "tid %d: cpu mask 0x%llx not applied, errno %d",
+                     tid, (unsigned long long)policy.cpuMask, errno);
+    }
+}
+
+void ThreadPolicy::apply(pal_thread_class_t cls, const char *name)
+{
+    static thread_local struct ExitGuard guard;
+    struct thread_policy_entry entry;
+    pid_t tid = currentTid();
+
+    if (cls >= PAL_THREAD_CLASS_MAX)
+        return;
+
+    memset(&entry, 0, sizeof(entry));
+    entry.cls = cls;
+    strlcpy(entry.name, name, sizeof(entry.name));
+    pthread_setname_np(pthread_self(), entry.name);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    applyTo(tid, cls);
+    threads_[tid] = entry;
+    guard.tid = tid;
+    PAL_DBG(LOG_TAG, "thread %s (tid %d) in class %s", entry.name, tid,
+            threadClassNames[cls]);
+}
+
+void ThreadPolicy::untrack(pid_t tid)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    threads_.erase(tid);
+}
+
+void ThreadPolicy::configure(const char **attr)
+{
+    int cls = PAL_THREAD_CLASS_MAX;
+    struct thread_class_policy policy;
+
+    for (int i = 0; attr[i] && attr[i + 1]; i += 2) {
+        if (strcmp(attr[i], "class"))
+            continue;
+        for (cls = 0; cls < PAL_THREAD_CLASS_MAX; cls++) {
+            if (!strcmp(attr[i + 1], threadClassNames[cls]))
+                break;
+        }
+    }
+    if (cls == PAL_THREAD_CLASS_MAX) {
+        PAL_ERR(LOG_TAG, "thread_policy without a valid class");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy = policies_[cls];
+    for (int i = 0; attr[i] && attr[i + 1]; i += 2) {
+        if (!strcmp(attr[i], "sched")) {
+            if (!strcmp(attr[i + 1], "fifo"))
+                policy.schedPolicy = SCHED_FIFO;
+            else if (!strcmp(attr[i + 1], "rr"))
+                policy.schedPolicy = SCHED_RR;
+            else if (!strcmp(attr[i + 1], "other"))
+                policy.schedPolicy = SCHED_OTHER;
+            else
+                PAL_ERR(LOG_TAG, "unknown sched %s", attr[i + 1]);
+        } else if (!strcmp(attr[i], "priority")) {
+            policy.rtPriority = atoi(attr[i + 1]);
+        } else if (!strcmp(attr[i], "nice")) {
+            policy.nice = atoi(attr[i + 1]);
+        } else if (!strcmp(attr[i], "cpus")) {
+            policy.cpuMask = parseCpuList(attr[i + 1]);
+            if (!policy.cpuMask)
+                PAL_ERR(LOG_TAG, "invalid cpu list %s", attr[i + 1]);
+        }
+    }
+
+    if (policy.schedPolicy != SCHED_OTHER &&
+        (policy.rtPriority < sched_get_priority_min(policy.schedPolicy) ||
+         policy.rtPriority > sched_get_priority_max(policy.schedPolicy))) {
+        PAL_ERR(LOG_TAG, "invalid rt priority %d for class %s",
+                policy.rtPriority, threadClassNames[cls]);
+        return;
+    }
+
+    policies_[cls] = policy;
+    PAL_INFO(LOG_TAG, "class %s: sched %d prio %d nice %d cpus 0x%llx",
+             threadClassNames[cls], policy.schedPolicy, policy.rtPriority,
+             policy.nice, (unsigned long long)policy.cpuMask);
+
+    for (auto &thread : threads_) {
+        if (thread.second.cls == cls)
+            applyTo(thread.first, (pal_thread_class_t)cls);
+    }
+}
+
+void ThreadPolicy::query(std::vector<pal_thread_policy_info_t> &info)
+{
+    pal_thread_policy_info_t thread_info;
+    struct sched_param param;
+    cpu_set_t cpus;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    info.clear();
+    for (auto &thread : threads_) {
+        memset(&thread_info, 0, sizeof(thread_info));
+        thread_info.tid = thread.first;
+        strlcpy(thread_info.name, thread.second.name, sizeof(thread_info.name));
+        strlcpy(thread_info.thread_class, threadClassNames[thread.second.cls],
+                sizeof(thread_info.thread_class));
+
+        thread_info.sched_policy = sched_getscheduler(thread.first);
+        if (thread_info.sched_policy < 0)
+            continue;   /* exited without running its guard yet */
+        if (!sched_getparam(thread.first, &param))
+            thread_info.rt_priority = param.sched_priority;
+        thread_info.nice = getpriority(PRIO_PROCESS, thread.first);
+        CPU_ZERO(&cpus);
+        if (!sched_getaffinity(thread.first, sizeof(cpus), &cpus)) {
+            for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &cpus))
+                    thread_info.cpu_mask |= 1ULL << cpu;
+            }
+        }
+        info.push_back(thread_info);
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#define LOG_TAG "PAL: TimerScheduler"
+
+#include "TimerScheduler.h"
+#include "PalCommon.h"
+#include "ThreadPolicy.h"
+
+#include <system_error>
+#include <thread>
+
+TimerScheduler* TimerScheduler::getInstance()
+{
+    /* never destroyed, the detached thread may still reference it at exit */
+    static TimerScheduler *instance = new TimerScheduler();
+
+    return instance;
+}
+
+TimerScheduler::TimerScheduler()
+    : nextId_(1),
+      runningId_(0),
+      started_(false)
+{
+}
+
+uint64_t TimerScheduler::schedule(uint32_t delayMs, timer_handler handler, void *cookie)
+{
+    struct timer_entry entry;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!handler)
+        return 0;
+
+    if (!started_) {
+        try {
+            std::thread(timerLoop, this).detach();
+        } catch (const std::system_error &e) {
+            PAL_ERR(LOG_TAG, "failed to create timer thread: %s", e.what());
+            return 0;
+        }
+        started_ = true;
+    }
+
+    entry.id = nextId_++;
+    entry.handler = handler;
+    entry.cookie = cookie;
+    timers_.insert(std::make_pair(std::chrono::steady_clock::now() +
+                                  std::chrono::milliseconds(delayMs), entry));
+    cv_.notify_one();
+    PAL_VERBOSE(LOG_TAG, "timer %llu in %u ms", (unsigned long long)entry.id, delayMs);
+
+    return entry.id;
+}
+
+bool TimerScheduler::cancel(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!id)
+        return false;
+
+    for (auto it = timers_.begin(); it != timers_.end(); it++) {
+        if (it->second.id == id) {
+            timers_.erase(it);
+            PAL_VERBOSE(LOG_TAG, "timer %llu cancelled", (unsigned long long)id);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TimerScheduler::cancelSync(uint64_t id)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!id)
+        return false;
+
+    for (auto it = timers_.begin(); it != timers_.end(); it++) {
+        if (it->second.id == id) {
+            timers_.erase(it);
+            PAL_VERBOSE(LOG_TAG, "timer %llu cancelled", (unsigned long long)id);
+            return true;
+        }
+    }
+    if (runningId_ == id) {
+        PAL_DBG(LOG_TAG, "timer %llu running, waiting for it", (unsigned long long)id);
+        doneCv_.wait(lock, [this, id] { return runningId_ != id; });
+    }
+    return false;
+}
+
+void TimerScheduler::reschedule(uint64_t *id, uint32_t delayMs, timer_handler handler,
+                                void *cookie)
+{
+    cancel(*id);
+    *id = schedule(delayMs, handler, cookie);
+}
+
+void TimerScheduler::timerLoop(TimerScheduler *sched)
+{
+    ThreadPolicy::getInstance()->apply(PAL_THREAD_CLASS_EVENT, "pal_timer");
+
+    std::unique_lock<std::mutex> lock(sched->mutex_);
+
+    while (true) {
+        if (sched->timers_.empty()) {
+            sched->cv_.wait(lock);
+            continue;
+        }
+
+        auto first = sched->timers_.begin();
+        if (first->first > std::chrono::steady_clock::now()) {
+            sched->cv_.wait_until(lock, first->first);
+            continue;
+        }
+
+        struct timer_entry entry = first->second;
+        sched->timers_.erase(first);
+        sched->runningId_ = entry.id;
+        lock.unlock();
+
+        entry.handler(entry.cookie);
+
+        lock.lock();
+        sched->runningId_ = 0;
+        sched->doneCv_.notify_all();
+    }
+}